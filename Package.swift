@@ -20,7 +20,7 @@ let package = Package(
             dependencies: [],
             path: "cpp_src",
             sources: [
-                "PureScanner.cpp", "PureParser.cpp"
+                "PureScanner.cpp", "PureParser.cpp", "PureSession.cpp", "PureStreamParser.cpp", "PureOutput.cpp", "PureReference.cpp", "PureAccounting.cpp", "PureStatistics.cpp", "PureProfiler.cpp", "PureTracing.cpp", "PureBindings.cpp", "PureBundle.cpp", "PureJson.cpp", "PureSharedBindings.cpp", "PureSharedTable.cpp", "PureEpoch.cpp", "PureBundleManager.cpp", "PureUnicode.cpp"
             ],
             publicHeadersPath: "."),
         .target(
@@ -8,11 +8,37 @@
 
 #include "pure_parser.h"
 #include "../cpp_src/PureParser.hpp"
-#include <regex>
-#include <iostream>
+#include "../cpp_src/PureBindings.hpp"
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
 #include <optional>
+#include <string_view>
 
-static inline PureParser* get_impl(pure_parser_t *parser);
+/**
+ * The parser along with the last formula performed
+ */
+struct pure_parser_impl_t {
+    PureParser parser;
+    std::optional<PureFormula> formula;
+};
+
+/**
+ * The compiled formula along with the parser to execute it
+ */
+struct pure_formula_impl_t {
+    PureParser parser;
+    PureFormula formula;
+};
+
+static inline pure_parser_impl_t* get_impl(pure_parser_t *parser);
+static inline const pure_formula_impl_t* get_impl(const pure_formula_t *formula);
+static inline PureBindings* get_impl(pure_bindings_t *bindings);
+static inline const PureBindings* get_impl(const pure_bindings_t *bindings);
+static inline PureConfig make_config(const pure_config_t *config);
+static inline void copy_output(const std::string &result, char **output, unsigned long *output_len);
+static inline void terminate_output(size_t output_len, char *output, unsigned long output_capacity);
+static inline size_t perform_job(const pure_job_t *job, char *output, size_t output_capacity);
 
 void pure_config_set_default(pure_config_t *config) {
     config->element_token = kPureParserDefaultElementToken;
@@ -23,19 +49,14 @@ void pure_config_set_default(pure_config_t *config) {
 }
 
 void pure_parser_init(pure_parser_t *parser, const pure_config_t *config) {
-    PureConfig impl_config {
-        .element_token = config->element_token,
-        .block_opener_token = config->block_opener_token,
-        .block_closer_token = config->block_closer_token,
-        .separator_token = config->separator_token,
-        .alias_token = config->alias_token
+    parser->impl = new pure_parser_impl_t {
+        .parser = PureParser(make_config(config)),
+        .formula = std::nullopt
     };
-
-    parser->impl = new PureParser(impl_config);
 }
 
 void pure_parser_reset(pure_parser_t *parser) {
-    get_impl(parser)->reset();
+    get_impl(parser)->parser.reset();
 }
 
 void pure_parser_destroy(pure_parser_t *parser) {
@@ -43,23 +64,271 @@ void pure_parser_destroy(pure_parser_t *parser) {
 }
 
 void pure_parser_assign_var(pure_parser_t *parser, const char *name, const char *value) {
-    get_impl(parser)->assignVariable(name, value);
+    pure_parser_assign_var_n(parser, name, strlen(name), value, strlen(value));
+}
+
+void pure_parser_assign_var_n(pure_parser_t *parser, const char *name, unsigned long name_len, const char *value, unsigned long value_len) {
+    get_impl(parser)->parser.assignVariable(std::string_view(name, name_len), std::string_view(value, value_len));
+}
+
+void pure_parser_assign_vars(pure_parser_t *parser, const pure_var_t *vars, unsigned long vars_number) {
+    PureParser &impl_parser = get_impl(parser)->parser;
+    for (const pure_var_t *var = vars, *end = vars + vars_number; var < end; var++) {
+        impl_parser.assignVariable(std::string_view(var->name.data, var->name.len), std::string_view(var->value.data, var->value.len));
+    }
 }
 
 void pure_parser_discard_var(pure_parser_t *parser, const char *name) {
-    get_impl(parser)->discardVariable(name);
+    pure_parser_discard_var_n(parser, name, strlen(name));
+}
+
+void pure_parser_discard_var_n(pure_parser_t *parser, const char *name, unsigned long name_len) {
+    get_impl(parser)->parser.discardVariable(std::string_view(name, name_len));
+}
+
+void pure_parser_assign_var_view(pure_parser_t *parser, const char *name, unsigned long name_len, const char *value, unsigned long value_len) {
+    get_impl(parser)->parser.assignVariableView(std::string_view(name, name_len), std::string_view(value, value_len));
 }
 
 void pure_parser_enable_alias(pure_parser_t *parser, const char *name) {
-    get_impl(parser)->enableAlias(name);
+    pure_parser_enable_alias_n(parser, name, strlen(name));
+}
+
+void pure_parser_enable_alias_n(pure_parser_t *parser, const char *name, unsigned long name_len) {
+    get_impl(parser)->parser.enableAlias(std::string_view(name, name_len));
 }
 
 void pure_parser_discard_alias(pure_parser_t *parser, const char *name) {
-    get_impl(parser)->disableAlias(name);
+    pure_parser_discard_alias_n(parser, name, strlen(name));
+}
+
+void pure_parser_discard_alias_n(pure_parser_t *parser, const char *name, unsigned long name_len) {
+    get_impl(parser)->parser.disableAlias(std::string_view(name, name_len));
+}
+
+bool pure_parser_assign_json(pure_parser_t *parser, const char *json) {
+    return pure_parser_assign_json_n(parser, json, strlen(json));
+}
+
+bool pure_parser_assign_json_n(pure_parser_t *parser, const char *json, unsigned long json_len) {
+    return get_impl(parser)->parser.assignJson(std::string_view(json, json_len));
+}
+
+unsigned long pure_parser_perform(pure_parser_t *parser, const char *formula, bool collapse_spaces, bool reset_on_finish, char *output, unsigned long output_capacity) {
+    return pure_parser_perform_n(parser, formula, strlen(formula), collapse_spaces, reset_on_finish, output, output_capacity);
+}
+
+unsigned long pure_parser_perform_n(pure_parser_t *parser, const char *formula, unsigned long formula_len, bool collapse_spaces, bool reset_on_finish, char *output, unsigned long output_capacity) {
+    pure_parser_impl_t *impl = get_impl(parser);
+
+    // Recognize the formula only if it differs from the last one
+    const std::string_view formula_view(formula, formula_len);
+    if (not impl->formula.has_value() || impl->formula->source != formula_view) {
+        impl->formula = impl->parser.compile(std::string(formula_view));
+    }
+
+    // Keep the last byte for terminating zero;
+    // without any byte even the empty output does not fit, so nothing gets reset
+    const size_t text_capacity = (output_capacity > 0 ? output_capacity - 1 : 0);
+    const size_t output_len = impl->parser.execute(*impl->formula, collapse_spaces, reset_on_finish && output_capacity > 0, output, text_capacity);
+
+    terminate_output(output_len, output, output_capacity);
+    return output_len;
 }
 
 void pure_parser_execute(pure_parser_t *parser, const char *formula, bool collapse_spaces, bool reset_on_finish, char **output, unsigned long *output_len) {
-    const std::string result = get_impl(parser)->execute(formula, collapse_spaces, reset_on_finish);
+    pure_parser_execute_n(parser, formula, strlen(formula), collapse_spaces, reset_on_finish, output, output_len);
+}
+
+void pure_parser_execute_n(pure_parser_t *parser, const char *formula, unsigned long formula_len, bool collapse_spaces, bool reset_on_finish, char **output, unsigned long *output_len) {
+    const std::string result = get_impl(parser)->parser.execute(std::string(formula, formula_len), collapse_spaces, reset_on_finish);
+    copy_output(result, output, output_len);
+}
+
+void pure_formula_init(pure_formula_t *formula, const pure_config_t *config, const char *source) {
+    pure_formula_init_n(formula, config, source, strlen(source));
+}
+
+void pure_formula_init_n(pure_formula_t *formula, const pure_config_t *config, const char *source, unsigned long source_len) {
+    PureParser impl_parser(make_config(config));
+    PureFormula impl_formula = impl_parser.compile(std::string(source, source_len));
+
+    formula->impl = new pure_formula_impl_t {
+        .parser = std::move(impl_parser),
+        .formula = std::move(impl_formula)
+    };
+}
+
+void pure_formula_destroy(pure_formula_t *formula) {
+    delete (pure_formula_impl_t *) formula->impl;
+}
+
+void pure_bindings_init(pure_bindings_t *bindings) {
+    bindings->impl = new PureBindings();
+}
+
+void pure_bindings_reset(pure_bindings_t *bindings) {
+    get_impl(bindings)->reset();
+}
+
+void pure_bindings_destroy(pure_bindings_t *bindings) {
+    delete get_impl(bindings);
+}
+
+void pure_bindings_assign_var(pure_bindings_t *bindings, const char *name, const char *value) {
+    pure_bindings_assign_var_n(bindings, name, strlen(name), value, strlen(value));
+}
+
+void pure_bindings_assign_var_n(pure_bindings_t *bindings, const char *name, unsigned long name_len, const char *value, unsigned long value_len) {
+    get_impl(bindings)->assignVariable(std::string_view(name, name_len), std::string_view(value, value_len));
+}
+
+void pure_bindings_assign_vars(pure_bindings_t *bindings, const pure_var_t *vars, unsigned long vars_number) {
+    PureBindings *impl_bindings = get_impl(bindings);
+    for (const pure_var_t *var = vars, *end = vars + vars_number; var < end; var++) {
+        impl_bindings->assignVariable(std::string_view(var->name.data, var->name.len), std::string_view(var->value.data, var->value.len));
+    }
+}
+
+void pure_bindings_discard_var(pure_bindings_t *bindings, const char *name) {
+    pure_bindings_discard_var_n(bindings, name, strlen(name));
+}
+
+void pure_bindings_discard_var_n(pure_bindings_t *bindings, const char *name, unsigned long name_len) {
+    get_impl(bindings)->discardVariable(std::string_view(name, name_len));
+}
+
+void pure_bindings_assign_var_view(pure_bindings_t *bindings, const char *name, unsigned long name_len, const char *value, unsigned long value_len) {
+    get_impl(bindings)->assignVariableView(std::string_view(name, name_len), std::string_view(value, value_len));
+}
+
+void pure_bindings_enable_alias(pure_bindings_t *bindings, const char *name) {
+    pure_bindings_enable_alias_n(bindings, name, strlen(name));
+}
+
+void pure_bindings_enable_alias_n(pure_bindings_t *bindings, const char *name, unsigned long name_len) {
+    get_impl(bindings)->enableAlias(std::string_view(name, name_len));
+}
+
+void pure_bindings_discard_alias(pure_bindings_t *bindings, const char *name) {
+    pure_bindings_discard_alias_n(bindings, name, strlen(name));
+}
+
+void pure_bindings_discard_alias_n(pure_bindings_t *bindings, const char *name, unsigned long name_len) {
+    get_impl(bindings)->disableAlias(std::string_view(name, name_len));
+}
+
+bool pure_bindings_assign_json(pure_bindings_t *bindings, const char *json) {
+    return pure_bindings_assign_json_n(bindings, json, strlen(json));
+}
+
+bool pure_bindings_assign_json_n(pure_bindings_t *bindings, const char *json, unsigned long json_len) {
+    return get_impl(bindings)->assignJson(std::string_view(json, json_len));
+}
+
+void pure_bindings_set_parent(pure_bindings_t *bindings, const pure_bindings_t *parent) {
+    get_impl(bindings)->setParent(parent ? get_impl(parent) : nullptr);
+}
+
+void pure_parser_set_parent(pure_parser_t *parser, const pure_bindings_t *parent) {
+    get_impl(parser)->parser.setParentScope(parent ? get_impl(parent) : nullptr);
+}
+
+unsigned long pure_formula_perform(const pure_formula_t *formula, const pure_bindings_t *bindings, bool collapse_spaces, char *output, unsigned long output_capacity) {
+    const pure_job_t job = { .formula = formula, .bindings = bindings, .collapse_spaces = collapse_spaces };
+    const size_t output_len = perform_job(&job, output, output_capacity);
+
+    terminate_output(output_len, output, output_capacity);
+    return output_len;
+}
+
+void pure_formula_execute(const pure_formula_t *formula, const pure_bindings_t *bindings, bool collapse_spaces, char **output, unsigned long *output_len) {
+    const pure_formula_impl_t *impl = get_impl(formula);
+    const std::string result = impl->parser.execute(impl->formula, *get_impl(bindings), collapse_spaces);
+    copy_output(result, output, output_len);
+}
+
+unsigned long pure_formula_perform_batch(const pure_job_t *jobs, unsigned long jobs_number, char *arena, unsigned long arena_capacity, pure_span_t *spans) {
+    size_t arena_len = 0;
+    
+    for (unsigned long index = 0; index < jobs_number; index++) {
+        // Once some output does not fit, the following ones are only measured
+        const size_t rest_capacity = (arena_len < arena_capacity ? arena_capacity - arena_len : 0);
+        char * const output = (rest_capacity > 0 ? arena + arena_len : NULL);
+        const size_t output_len = perform_job(&jobs[index], output, rest_capacity);
+        
+        if (output_len < rest_capacity) {
+            output[output_len] = 0x00;
+        }
+        
+        spans[index] = pure_span_t { .offset = arena_len, .len = output_len };
+        arena_len += output_len + 1;
+    }
+    
+    return arena_len;
+}
+
+void pure_formula_execute_batch(const pure_job_t *jobs, unsigned long jobs_number, char **arena, unsigned long *arena_len, pure_span_t *spans) {
+    size_t capacity = 256;
+    size_t collected_len = 0;
+    char *collected = (char *) malloc(capacity);
+    
+    for (unsigned long index = 0; collected && index < jobs_number; index++) {
+        size_t output_len = perform_job(&jobs[index], collected + collected_len, capacity - collected_len);
+        
+        // Grow the arena if the output does not fit, and perform the job again
+        if (output_len >= capacity - collected_len) {
+            capacity = std::max(capacity * 2, collected_len + output_len + 1);
+            char *grown = (char *) realloc(collected, capacity);
+            if (grown == NULL) {
+                free(collected);
+                collected = NULL;
+                break;
+            }
+            
+            collected = grown;
+            output_len = perform_job(&jobs[index], collected + collected_len, capacity - collected_len);
+        }
+        
+        collected[collected_len + output_len] = 0x00;
+        spans[index] = pure_span_t { .offset = collected_len, .len = output_len };
+        collected_len += output_len + 1;
+    }
+    
+    if (arena_len) {
+        *arena_len = (collected ? collected_len : 0);
+    }
+    
+    *arena = collected;
+}
+
+static inline pure_parser_impl_t* get_impl(pure_parser_t *parser) {
+    return (pure_parser_impl_t *) parser->impl;
+}
+
+static inline const pure_formula_impl_t* get_impl(const pure_formula_t *formula) {
+    return (const pure_formula_impl_t *) formula->impl;
+}
+
+static inline PureBindings* get_impl(pure_bindings_t *bindings) {
+    return (PureBindings *) bindings->impl;
+}
+
+static inline const PureBindings* get_impl(const pure_bindings_t *bindings) {
+    return (const PureBindings *) bindings->impl;
+}
+
+static inline PureConfig make_config(const pure_config_t *config) {
+    return PureConfig {
+        .element_token = config->element_token,
+        .block_opener_token = config->block_opener_token,
+        .block_closer_token = config->block_closer_token,
+        .separator_token = config->separator_token,
+        .alias_token = config->alias_token
+    };
+}
+
+static inline void copy_output(const std::string &result, char **output, unsigned long *output_len) {
     const size_t result_len = result.size();
     
     if (output_len) {
@@ -76,6 +345,19 @@ void pure_parser_execute(pure_parser_t *parser, const char *formula, bool collap
     }
 }
 
-static inline PureParser* get_impl(pure_parser_t *parser) {
-    return (PureParser *) parser->impl;
+static inline size_t perform_job(const pure_job_t *job, char *output, size_t output_capacity) {
+    const pure_formula_impl_t *impl = get_impl(job->formula);
+
+    // Keep the last byte for terminating zero
+    const size_t text_capacity = (output_capacity > 0 ? output_capacity - 1 : 0);
+    return impl->parser.execute(impl->formula, *get_impl(job->bindings), job->collapse_spaces, output, text_capacity);
+}
+
+static inline void terminate_output(size_t output_len, char *output, unsigned long output_capacity) {
+    if (output_len < output_capacity) {
+        output[output_len] = 0x00;
+    }
+    else if (output_capacity > 0) {
+        output[output_capacity - 1] = 0x00;
+    }
 }
@@ -31,6 +31,23 @@ typedef struct {
 */
 void pure_config_set_default(pure_config_t *config);
 
+/*
+ The string given by pointer and length, not necessarily terminated with zero;
+ may contain zeros within
+*/
+typedef struct {
+    const char *data;
+    unsigned long len;
+} pure_string_t;
+
+/*
+ The variable with its value, for assigning many variables at once
+*/
+typedef struct {
+    pure_string_t name;
+    pure_string_t value;
+} pure_var_t;
+
 /*
  Public parser context
 */
@@ -51,30 +68,160 @@ void pure_parser_destroy(pure_parser_t *parser);
 /*
  Variables management:
  - assign the variable with value
+ - assign many variables at once
  - discard the variable
+ (the `_n` variants take the strings by pointer and length)
 */
 void pure_parser_assign_var(pure_parser_t *parser, const char *name, const char *value);
+void pure_parser_assign_var_n(pure_parser_t *parser, const char *name, unsigned long name_len, const char *value, unsigned long value_len);
+void pure_parser_assign_vars(pure_parser_t *parser, const pure_var_t *vars, unsigned long vars_number);
 void pure_parser_discard_var(pure_parser_t *parser, const char *name);
+void pure_parser_discard_var_n(pure_parser_t *parser, const char *name, unsigned long name_len);
+
+/*
+ Assigning the value without copying it:
+ the value memory must stay valid until the variable gets reassigned, discarded, or reset,
+ which happens right after performing with `reset_on_finish`
+*/
+void pure_parser_assign_var_view(pure_parser_t *parser, const char *name, unsigned long name_len, const char *value, unsigned long value_len);
 
 /*
  Aliases management:
  - enable the alias
  - discard the alias
+ (the `_n` variants take the strings by pointer and length)
 */
 void pure_parser_enable_alias(pure_parser_t *parser, const char *name);
+void pure_parser_enable_alias_n(pure_parser_t *parser, const char *name, unsigned long name_len);
 void pure_parser_discard_alias(pure_parser_t *parser, const char *name);
+void pure_parser_discard_alias_n(pure_parser_t *parser, const char *name, unsigned long name_len);
 
 /*
- Performing:
- - calculates the formula with assigned variables and enabled aliases into the output
+ Assigning variables and aliases from the flat JSON object, like `{"name": "Anna", "number": 7, "vip": true}`:
+ strings and numbers go to variables, `null` discards the variable, and booleans enable or disable aliases;
+ returns `false` if the JSON is broken, keeping the fields assigned before the broken place
 */
-void pure_parser_perform(pure_parser_t *parser, const char *formula, bool collapse_spaces, bool reset_on_finish, char **output, unsigned long *output_len);
+bool pure_parser_assign_json(pure_parser_t *parser, const char *json);
+bool pure_parser_assign_json_n(pure_parser_t *parser, const char *json, unsigned long json_len);
+
+/*
+ Performing into the caller memory:
+ - calculates the formula with assigned variables and enabled aliases right into the `output` of `output_capacity` bytes,
+   terminated with zero
+ - returns the output length (without terminating zero); if it is not less than `output_capacity`,
+   the output is truncated and nothing gets reset, so it can be performed again with the larger buffer
+   (zero `output_capacity` never resets, so it may be used to measure the output)
+ - the last formula is kept recognized, so performing the same formula again does not allocate memory
+*/
+unsigned long pure_parser_perform(pure_parser_t *parser, const char *formula, bool collapse_spaces, bool reset_on_finish, char *output, unsigned long output_capacity);
+unsigned long pure_parser_perform_n(pure_parser_t *parser, const char *formula, unsigned long formula_len, bool collapse_spaces, bool reset_on_finish, char *output, unsigned long output_capacity);
 
 /*
  Performing:
- - calculates the formula with assigned variables and enabled aliases into the output
+ - calculates the formula with assigned variables and enabled aliases into the output,
+   being allocated by `malloc`; the caller is responsible to `free` it
 */
 void pure_parser_execute(pure_parser_t *parser, const char *formula, bool collapse_spaces, bool reset_on_finish, char **output, unsigned long *output_len);
+void pure_parser_execute_n(pure_parser_t *parser, const char *formula, unsigned long formula_len, bool collapse_spaces, bool reset_on_finish, char **output, unsigned long *output_len);
+
+/*
+ Compiled formula, recognized once and executed many times;
+ it is not changed by executing, so it can be executed from many threads at once
+*/
+typedef struct {
+    void *impl;
+} pure_formula_t;
+
+/*
+ Variables and aliases to execute compiled formulas with;
+ can be reset and filled again without freeing,
+ and read by many threads at once while nobody changes it
+*/
+typedef struct {
+    void *impl;
+} pure_bindings_t;
+
+/*
+ Formula memory management:
+ - compile the formula with the configuration, at first
+ - release the memory, at the end
+*/
+void pure_formula_init(pure_formula_t *formula, const pure_config_t *config, const char *source);
+void pure_formula_init_n(pure_formula_t *formula, const pure_config_t *config, const char *source, unsigned long source_len);
+void pure_formula_destroy(pure_formula_t *formula);
+
+/*
+ Bindings memory management:
+ - create the empty bindings, at first
+ - reset all variables & aliases, keeping the bindings for further usage
+ - release the memory, at the end
+*/
+void pure_bindings_init(pure_bindings_t *bindings);
+void pure_bindings_reset(pure_bindings_t *bindings);
+void pure_bindings_destroy(pure_bindings_t *bindings);
+
+/*
+ Bindings variables and aliases management, same as for the parser
+*/
+void pure_bindings_assign_var(pure_bindings_t *bindings, const char *name, const char *value);
+void pure_bindings_assign_var_n(pure_bindings_t *bindings, const char *name, unsigned long name_len, const char *value, unsigned long value_len);
+void pure_bindings_assign_vars(pure_bindings_t *bindings, const pure_var_t *vars, unsigned long vars_number);
+void pure_bindings_discard_var(pure_bindings_t *bindings, const char *name);
+void pure_bindings_discard_var_n(pure_bindings_t *bindings, const char *name, unsigned long name_len);
+void pure_bindings_assign_var_view(pure_bindings_t *bindings, const char *name, unsigned long name_len, const char *value, unsigned long value_len);
+void pure_bindings_enable_alias(pure_bindings_t *bindings, const char *name);
+void pure_bindings_enable_alias_n(pure_bindings_t *bindings, const char *name, unsigned long name_len);
+void pure_bindings_discard_alias(pure_bindings_t *bindings, const char *name);
+void pure_bindings_discard_alias_n(pure_bindings_t *bindings, const char *name, unsigned long name_len);
+bool pure_bindings_assign_json(pure_bindings_t *bindings, const char *json);
+bool pure_bindings_assign_json_n(pure_bindings_t *bindings, const char *json, unsigned long json_len);
+
+/*
+ Layering the bindings:
+ what is not assigned to the bindings or the parser gets looked up in the `parent` bindings,
+ e.g. the request bindings overlay the tenant ones, which overlay the global ones;
+ resetting keeps the parent, which must outlive its children; pass `NULL` to stop overlaying
+*/
+void pure_bindings_set_parent(pure_bindings_t *bindings, const pure_bindings_t *parent);
+void pure_parser_set_parent(pure_parser_t *parser, const pure_bindings_t *parent);
+
+/*
+ Performing the compiled formula with the bindings:
+ - into the caller memory, same as `pure_parser_perform`, but never resets the bindings
+ - into the output being allocated by `malloc`, same as `pure_parser_execute`
+*/
+unsigned long pure_formula_perform(const pure_formula_t *formula, const pure_bindings_t *bindings, bool collapse_spaces, char *output, unsigned long output_capacity);
+void pure_formula_execute(const pure_formula_t *formula, const pure_bindings_t *bindings, bool collapse_spaces, char **output, unsigned long *output_len);
+
+/*
+ Single job of the batch: the compiled formula to perform with the bindings
+*/
+typedef struct {
+    const pure_formula_t *formula;
+    const pure_bindings_t *bindings;
+    bool collapse_spaces;
+} pure_job_t;
+
+/*
+ Placement of the job output within the arena:
+ the output starts at `offset` and is followed by terminating zero
+*/
+typedef struct {
+    unsigned long offset;
+    unsigned long len;
+} pure_span_t;
+
+/*
+ Performing many jobs at once, one output after another within the single arena,
+ and filling `spans` with the placement of every output:
+ - into the caller memory, returning the required arena size;
+   the arena contains all outputs only if the returned size fits `arena_capacity`,
+   so you can retry with the larger arena otherwise
+ - into the arena being allocated by `malloc`, to be released by single `free`;
+   if the memory cannot be allocated, the arena is set to NULL, and its length to zero
+*/
+unsigned long pure_formula_perform_batch(const pure_job_t *jobs, unsigned long jobs_number, char *arena, unsigned long arena_capacity, pure_span_t *spans);
+void pure_formula_execute_batch(const pure_job_t *jobs, unsigned long jobs_number, char **arena, unsigned long *arena_len, pure_span_t *spans);
 
 #ifdef __cplusplus
 }
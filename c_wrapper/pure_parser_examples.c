@@ -7,6 +7,7 @@
 
 #include "pure_parser.h"
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 
 #pragma mark - Local Types
@@ -229,6 +230,189 @@ static void test_Coupons(example_meta_t *meta) {
     example_meta_set_reference(meta, "You have 7 coupon(s) expiring on 11/11/19");
 }
 
+static void test_PerformIntoBuffer(example_meta_t *meta) {
+    pure_config_t config;
+    pure_config_set_default(&config);
+    
+    pure_parser_t parser;
+    pure_parser_init(&parser, &config);
+    
+    const char *formula = "$[$name has ## You have] $[$number coupon(s) ## no coupons] expiring on $date";
+    pure_parser_assign_var(&parser, "number", "7");
+    pure_parser_assign_var(&parser, "date", "11/11/19");
+    
+    // The short buffer gets truncated output, and variables are kept for the next attempt,
+    // as well as after measuring even the empty output with no buffer
+    static char buffer[100];
+    pure_parser_perform(&parser, "", true, true, NULL, 0);
+    const unsigned long output_len = pure_parser_perform(&parser, formula, true, true, buffer, 8);
+    pure_parser_perform(&parser, formula, true, true, buffer, output_len + 1);
+    meta->output = buffer;
+    
+    example_meta_set_formula(meta, formula);
+    example_meta_set_variable(meta, 0, "number", "7");
+    example_meta_set_variable(meta, 1, "date", "11/11/19");
+    example_meta_set_reference(meta, "You have 7 coupon(s) expiring on 11/11/19");
+}
+
+static void test_SizedStrings(example_meta_t *meta) {
+    pure_config_t config;
+    pure_config_set_default(&config);
+    
+    pure_parser_t parser;
+    pure_parser_init(&parser, &config);
+    
+    // Names and values point into the single buffer without terminating zeros
+    const char *storage = "numberdate711/11/19";
+    const pure_var_t vars[] = {
+        { .name = { storage + 0, 6 }, .value = { storage + 10, 1 } },
+        { .name = { storage + 6, 4 }, .value = { storage + 11, 8 } }
+    };
+    pure_parser_assign_vars(&parser, vars, 2);
+    
+    const char *formula = "$[$name has ## You have] $[$number coupon(s) ## no coupons] expiring on $date; and more";
+    static char buffer[100];
+    pure_parser_perform_n(&parser, formula, strlen(formula) - strlen("; and more"), true, true, buffer, sizeof(buffer));
+    meta->output = buffer;
+    
+    example_meta_set_formula(meta, formula);
+    example_meta_set_variable(meta, 0, "number", "7");
+    example_meta_set_variable(meta, 1, "date", "11/11/19");
+    example_meta_set_reference(meta, "You have 7 coupon(s) expiring on 11/11/19");
+}
+
+static void test_FormulaWithBindings(example_meta_t *meta) {
+    pure_config_t config;
+    pure_config_set_default(&config);
+    
+    const char *formula = "$[$name has ## You have] $[$number coupon(s) ## no coupons] expiring on $date";
+    pure_formula_t compiled;
+    pure_formula_init(&compiled, &config, formula);
+    
+    // The bindings get filled again after reset, and the formula is not recognized twice
+    pure_bindings_t bindings;
+    pure_bindings_init(&bindings);
+    pure_bindings_assign_var(&bindings, "name", "Anna");
+    pure_bindings_reset(&bindings);
+    pure_bindings_assign_var(&bindings, "number", "7");
+    pure_bindings_assign_var(&bindings, "date", "11/11/19");
+    
+    static char buffer[100];
+    pure_formula_perform(&compiled, &bindings, true, buffer, sizeof(buffer));
+    meta->output = buffer;
+    
+    pure_bindings_destroy(&bindings);
+    pure_formula_destroy(&compiled);
+    
+    example_meta_set_formula(meta, formula);
+    example_meta_set_variable(meta, 0, "number", "7");
+    example_meta_set_variable(meta, 1, "date", "11/11/19");
+    example_meta_set_reference(meta, "You have 7 coupon(s) expiring on 11/11/19");
+}
+
+static void test_BatchIntoArena(example_meta_t *meta) {
+    pure_config_t config;
+    pure_config_set_default(&config);
+    
+    const char *formula = "$[$name has ## You have] $[$number coupon(s) ## no coupons] expiring on $date";
+    pure_formula_t compiled;
+    pure_formula_init(&compiled, &config, formula);
+    
+    pure_bindings_t first_bindings;
+    pure_bindings_init(&first_bindings);
+    pure_bindings_assign_var(&first_bindings, "name", "Anna");
+    pure_bindings_assign_var(&first_bindings, "date", "10/10/19");
+    
+    pure_bindings_t second_bindings;
+    pure_bindings_init(&second_bindings);
+    pure_bindings_assign_var(&second_bindings, "number", "7");
+    pure_bindings_assign_var(&second_bindings, "date", "11/11/19");
+    
+    const pure_job_t jobs[] = {
+        { .formula = &compiled, .bindings = &first_bindings, .collapse_spaces = true },
+        { .formula = &compiled, .bindings = &second_bindings, .collapse_spaces = true }
+    };
+    
+    // The small arena only gets measured, and the allocated one gets both outputs
+    static char small_arena[16];
+    pure_span_t spans[2];
+    const unsigned long required_len = pure_formula_perform_batch(jobs, 2, small_arena, sizeof(small_arena), spans);
+    
+    char *arena = NULL;
+    unsigned long arena_len = 0;
+    pure_formula_execute_batch(jobs, 2, &arena, &arena_len, spans);
+    
+    static char output[100];
+    const bool first_matches = (strcmp(arena + spans[0].offset, "Anna has no coupons expiring on 10/10/19") == 0);
+    strcpy(output, (first_matches && arena_len == required_len) ? arena + spans[1].offset : arena);
+    meta->output = output;
+    free(arena);
+    
+    pure_bindings_destroy(&first_bindings);
+    pure_bindings_destroy(&second_bindings);
+    pure_formula_destroy(&compiled);
+    
+    example_meta_set_formula(meta, formula);
+    example_meta_set_variable(meta, 0, "number", "7");
+    example_meta_set_variable(meta, 1, "date", "11/11/19");
+    example_meta_set_reference(meta, "You have 7 coupon(s) expiring on 11/11/19");
+}
+
+static void test_JsonVariables(example_meta_t *meta) {
+    pure_config_t config;
+    pure_config_set_default(&config);
+    
+    pure_parser_t parser;
+    pure_parser_init(&parser, &config);
+    
+    const char *formula = "$[$name has ## You have] $[$number coupon(s) ## no coupons] expiring on $date";
+    const char *json = "{\"number\": 7, \"date\": \"11/11/19\", \"name\": null}";
+    
+    static char buffer[100];
+    if (pure_parser_assign_json(&parser, json)) {
+        pure_parser_perform(&parser, formula, true, true, buffer, sizeof(buffer));
+    }
+    meta->output = buffer;
+    
+    example_meta_set_formula(meta, formula);
+    example_meta_set_variable(meta, 0, "number", "7");
+    example_meta_set_variable(meta, 1, "date", "11/11/19");
+    example_meta_set_reference(meta, "You have 7 coupon(s) expiring on 11/11/19");
+}
+
+static void test_LayeredBindings(example_meta_t *meta) {
+    pure_config_t config;
+    pure_config_set_default(&config);
+    
+    // The tenant variables are assigned once, and survive the parser resets
+    pure_bindings_t tenant;
+    pure_bindings_init(&tenant);
+    pure_bindings_assign_var(&tenant, "company", "JivoSite");
+    pure_bindings_assign_var(&tenant, "number", "0");
+    
+    pure_parser_t parser;
+    pure_parser_init(&parser, &config);
+    pure_parser_set_parent(&parser, &tenant);
+    
+    const char *formula = "$company: $[$number coupon(s) ## no coupons] expiring on $date";
+    static char buffer[100];
+    pure_parser_assign_var(&parser, "date", "10/10/19");
+    pure_parser_perform(&parser, formula, true, true, buffer, sizeof(buffer));
+    
+    pure_parser_assign_var(&parser, "number", "7");
+    pure_parser_assign_var(&parser, "date", "11/11/19");
+    pure_parser_perform(&parser, formula, true, true, buffer, sizeof(buffer));
+    meta->output = buffer;
+    
+    pure_parser_destroy(&parser);
+    pure_bindings_destroy(&tenant);
+    
+    example_meta_set_formula(meta, formula);
+    example_meta_set_variable(meta, 0, "number", "7");
+    example_meta_set_variable(meta, 1, "date", "11/11/19");
+    example_meta_set_reference(meta, "JivoSite: 7 coupon(s) expiring on 11/11/19");
+}
+
 #pragma mark - Execute all examples
 
 #ifndef main_c
@@ -246,7 +430,13 @@ int main_c() {
         declare_example_case(test_InactiveBlock),
         declare_example_case(test_ComplexActiveAlias),
         declare_example_case(test_ComplexInactiveAlias),
-        declare_example_case(test_Coupons)
+        declare_example_case(test_Coupons),
+        declare_example_case(test_PerformIntoBuffer),
+        declare_example_case(test_SizedStrings),
+        declare_example_case(test_FormulaWithBindings),
+        declare_example_case(test_BatchIntoArena),
+        declare_example_case(test_JsonVariables),
+        declare_example_case(test_LayeredBindings)
     };
     #undef declare_example_case
     
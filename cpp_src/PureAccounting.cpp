@@ -0,0 +1,65 @@
+//
+//  PureAccounting.cpp
+//  PureParser
+//
+//  Copyright © 2019 JivoSite Inc. All rights reserved.
+//  <For detailed info about how this parser works, please refer to README.md file>
+//
+
+#include "PureAccounting.hpp"
+
+typedef std::chrono::steady_clock accounting_clock_t;
+
+static thread_local PureAccounting current_accounting;
+static thread_local PurePhase current_phase = PurePhaseOther;
+static thread_local accounting_clock_t::time_point current_phase_started_at;
+
+static void switch_phase(PurePhase phase);
+
+bool PureAccountant::isEnabled() {
+#ifdef PURE_PARSER_ACCOUNTING
+    return true;
+#else
+    return false;
+#endif
+}
+
+void PureAccountant::recordAllocation(size_t bytes) {
+    PurePhaseUsage &usage = current_accounting.phases[current_phase];
+    usage.allocations++;
+    usage.allocated_bytes += bytes;
+}
+
+PureAccounting PureAccountant::snapshot() {
+    return current_accounting;
+}
+
+double PureAccountant::elapsedTime(PurePhase phase) {
+    return current_accounting.phases[phase].elapsed_ns;
+}
+
+void PureAccountant::reset() {
+    current_accounting = PureAccounting();
+}
+
+void PurePhaseScope::enter(PurePhase phase) {
+    this->_outer_phase = current_phase;
+    current_accounting.phases[phase].entries++;
+    switch_phase(phase);
+}
+
+void PurePhaseScope::leave() {
+    switch_phase(_outer_phase);
+}
+
+static void switch_phase(PurePhase phase) {
+    // Account the time passed to the phase being left,
+    // and start counting for the new one
+    const auto now = accounting_clock_t::now();
+    if (current_phase != PurePhaseOther) {
+        current_accounting.phases[current_phase].elapsed_ns += std::chrono::duration<double, std::nano>(now - current_phase_started_at).count();
+    }
+
+    current_phase = phase;
+    current_phase_started_at = now;
+}
@@ -0,0 +1,111 @@
+//
+//  PureAccounting.hpp
+//  PureParser
+//
+//  Copyright © 2019 JivoSite Inc. All rights reserved.
+//  <For detailed info about how this parser works, please refer to README.md file>
+//
+
+#ifndef PureAccounting_hpp
+#define PureAccounting_hpp
+
+#include <cstddef>
+#include <chrono>
+
+/**
+ * The phases of execution,
+ * to account the resources of each one separately
+ */
+enum PurePhase {
+    /// Anything outside of other phases
+    PurePhaseOther,
+
+    /// Scanning the formula into the tree
+    PurePhaseRecognize,
+
+    /// Producing the output from the tree
+    PurePhaseResolve,
+
+    /// Removing extra spaces from the output
+    PurePhaseCollapse,
+
+    PurePhasesNumber
+};
+
+/**
+ * Resources used within a phase
+ */
+struct PurePhaseUsage {
+    size_t entries = 0;
+    size_t allocations = 0;
+    size_t allocated_bytes = 0;
+    double elapsed_ns = 0;
+};
+
+/**
+ * Resources used within all phases
+ */
+struct PureAccounting {
+    PurePhaseUsage phases[PurePhasesNumber];
+};
+
+/**
+ * The accountant,
+ * collects the resources used by the current thread phase by phase;
+ * the phases marks are always compiled in, and are active when the library is built with `PURE_PARSER_ACCOUNTING` defined,
+ * or otherwise while the statistics are enabled, which is checked at runtime by every mark;
+ * allocations are accounted only when the host application reports them by `recordAllocation`
+ */
+class PureAccountant {
+public:
+    /**
+     * Whether the library is built to mark the phases of every execution,
+     * rather than only while the statistics are enabled
+     */
+    static bool isEnabled();
+
+    /**
+     * Account the allocation within the current phase;
+     * supposed to be called from the replaced `operator new` of the host application
+     * @param bytes size of allocated memory
+     */
+    static void recordAllocation(size_t bytes);
+
+    /**
+     * Get the resources used so far
+     */
+    static PureAccounting snapshot();
+
+    /**
+     * Get the time spent within the phase so far
+     */
+    static double elapsedTime(PurePhase phase);
+
+    /**
+     * Forget the resources used so far
+     */
+    static void reset();
+};
+
+/**
+ * Marks the phase for the lifetime of the scope;
+ * the time of nested phases is not accounted for the outer ones
+ */
+class PurePhaseScope {
+public:
+    PurePhaseScope(PurePhase phase, bool active) : _active(active) { if (active) enter(phase); }
+    ~PurePhaseScope() { if (_active) leave(); }
+
+    PurePhaseScope(const PurePhaseScope &) = delete;
+    PurePhaseScope &operator=(const PurePhaseScope &) = delete;
+
+private:
+    void enter(PurePhase phase);
+    void leave();
+
+private:
+    bool _active;
+    PurePhase _outer_phase;
+};
+
+#endif /* PureAccounting_hpp */
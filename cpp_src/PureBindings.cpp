@@ -0,0 +1,200 @@
+//
+//  PureBindings.cpp
+//  PureParser
+//
+//  Copyright © 2019 JivoSite Inc. All rights reserved.
+//  <For detailed info about how this parser works, please refer to README.md file>
+//
+
+#include "PureBindings.hpp"
+#include "PureJson.hpp"
+
+/// Unused entries are kept for reusing until there are too many of them,
+/// e.g. when every execution gets its own variable names
+static const size_t kPureBindingsRetainedEntriesLimit = 1024;
+
+PureBindings::PureBindings(const PureScope *parent) {
+    this->_parent = parent;
+}
+
+void PureBindings::setParent(const PureScope *parent) {
+    _parent = parent;
+}
+
+const PureScope *PureBindings::parent() const {
+    return _parent;
+}
+
+void PureBindings::reset() {
+    if (_variables.size() + _aliases.size() > kPureBindingsRetainedEntriesLimit) {
+        _variables.clear();
+        _aliases.clear();
+    }
+
+    _generation++;
+}
+
+bool PureBindings::assignVariable(std::string_view name, std::string_view value) {
+    // Copy into the memory the entry already has, if it owns any,
+    // so the steady cycles of assigning and resetting do not allocate
+    const auto variable_iter = _variables.lower_bound(name);
+    if (variable_iter == _variables.end() || variable_iter->first != name) {
+        _variables.emplace_hint(variable_iter, name, Variable { .value = std::string(value), .generation = _generation, .discarded = false });
+        return true;
+    }
+
+    Variable &variable = variable_iter->second;
+    const bool changed = (variable.generation != _generation) || variable.discarded
+        || std::visit([&](const auto &current) { return std::string_view(current) != value; }, variable.value);
+
+    if (std::string *storage = std::get_if<std::string>(&variable.value)) {
+        storage->assign(value);
+    }
+    else {
+        variable.value = std::string(value);
+    }
+
+    variable.generation = _generation;
+    variable.discarded = false;
+    return changed;
+}
+
+bool PureBindings::assignVariableView(std::string_view name, std::string_view value) {
+    // Keep pointing into the caller memory even if the value is the same
+    const auto variable_iter = _variables.lower_bound(name);
+    if (variable_iter == _variables.end() || variable_iter->first != name) {
+        _variables.emplace_hint(variable_iter, name, Variable { .value = value, .generation = _generation, .discarded = false });
+        return true;
+    }
+
+    Variable &variable = variable_iter->second;
+    const bool changed = (variable.generation != _generation) || variable.discarded
+        || std::visit([&](const auto &current) { return std::string_view(current) != value; }, variable.value);
+
+    variable.value = value;
+    variable.generation = _generation;
+    variable.discarded = false;
+    return changed;
+}
+
+bool PureBindings::discardVariable(std::string_view name) {
+    const bool changed = findVariable(name).has_value();
+
+    // The discarded entry masks the parent variable until reset,
+    // so the entry is constructed only if there is the parent to mask
+    const auto variable_iter = _variables.lower_bound(name);
+    if (variable_iter == _variables.end() || variable_iter->first != name) {
+        if (_parent) {
+            _variables.emplace_hint(variable_iter, name, Variable { .value = std::string(), .generation = _generation, .discarded = true });
+        }
+
+        return changed;
+    }
+
+    variable_iter->second.generation = _generation;
+    variable_iter->second.discarded = true;
+    return changed;
+}
+
+bool PureBindings::enableAlias(std::string_view name) {
+    // Construct the name only if the alias has never been mentioned
+    const auto alias_iter = _aliases.lower_bound(name);
+    if (alias_iter == _aliases.end() || alias_iter->first != name) {
+        _aliases.emplace_hint(alias_iter, name, Alias { .generation = _generation, .enabled = true });
+        return true;
+    }
+
+    const bool changed = (alias_iter->second.generation != _generation) || not alias_iter->second.enabled;
+    alias_iter->second = Alias { .generation = _generation, .enabled = true };
+    return changed;
+}
+
+bool PureBindings::disableAlias(std::string_view name) {
+    const bool changed = isAliasEnabled(name);
+
+    // Same as discarded variables, the disabled alias masks the parent one
+    const auto alias_iter = _aliases.lower_bound(name);
+    if (alias_iter == _aliases.end() || alias_iter->first != name) {
+        if (_parent) {
+            _aliases.emplace_hint(alias_iter, name, Alias { .generation = _generation, .enabled = false });
+        }
+
+        return changed;
+    }
+
+    alias_iter->second = Alias { .generation = _generation, .enabled = false };
+    return changed;
+}
+
+bool PureBindings::assignJson(std::string_view json) {
+    return assignJson(json, false);
+}
+
+bool PureBindings::assignJsonView(std::string_view json) {
+    return assignJson(json, true);
+}
+
+bool PureBindings::assignJson(std::string_view json, bool borrow_values) {
+    // Array items have no names to assign
+    const size_t start = json.find_first_not_of(" \t\r\n");
+    if (start == std::string_view::npos || json[start] != '{') {
+        return false;
+    }
+
+    PureJsonReader reader(json);
+    PureJsonField field;
+
+    while (reader.next(field)) {
+        switch (field.type) {
+            case PureJsonTypeString:
+            case PureJsonTypeNumber:
+                // Decoded strings live in the reader, so they get copied anyway
+                if (borrow_values && reader.pointsIntoJson(field.value)) {
+                    assignVariableView(field.name, field.value);
+                }
+                else {
+                    assignVariable(field.name, field.value);
+                }
+                break;
+
+            case PureJsonTypeNull:
+                discardVariable(field.name);
+                break;
+
+            case PureJsonTypeTrue:
+                enableAlias(field.name);
+                break;
+
+            case PureJsonTypeFalse:
+                disableAlias(field.name);
+                break;
+
+            case PureJsonTypeObject:
+            case PureJsonTypeArray:
+                return false;
+        }
+    }
+
+    return not reader.failed();
+}
+
+std::optional<std::string_view> PureBindings::findVariable(std::string_view name) const {
+    const auto variable_iter = _variables.find(name);
+    if (variable_iter == _variables.end() || variable_iter->second.generation != _generation) {
+        return (_parent ? _parent->findVariable(name) : std::nullopt);
+    }
+    else if (variable_iter->second.discarded) {
+        return std::nullopt;
+    }
+
+    return std::visit([](const auto &value) { return std::string_view(value); }, variable_iter->second.value);
+}
+
+bool PureBindings::isAliasEnabled(std::string_view name) const {
+    const auto alias_iter = _aliases.find(name);
+    if (alias_iter != _aliases.end() && alias_iter->second.generation == _generation) {
+        return alias_iter->second.enabled;
+    }
+
+    return (_parent && _parent->isAliasEnabled(name));
+}
@@ -0,0 +1,129 @@
+//
+//  PureBindings.hpp
+//  PureParser
+//
+//  Copyright © 2019 JivoSite Inc. All rights reserved.
+//  <For detailed info about how this parser works, please refer to README.md file>
+//
+
+#ifndef PureBindings_hpp
+#define PureBindings_hpp
+
+#include "PureScope.hpp"
+#include <string>
+#include <string_view>
+#include <map>
+#include <optional>
+#include <variant>
+#include <functional>
+#include <cstdint>
+
+/**
+ * The variables and aliases to execute formulas with;
+ * can be reset and filled again between executions,
+ * and read by many threads at once while nobody changes it;
+ * resetting only bumps the generation, so the entries and their memory
+ * get reused by the next assignments instead of being freed and allocated again
+ */
+class PureBindings: public PureScope {
+public:
+    /**
+     * Create the bindings overlaying the `parent` scope, if any:
+     * what is not assigned here gets looked up there;
+     * the parent is not copied, so it must outlive the bindings
+     */
+    explicit PureBindings(const PureScope *parent = nullptr);
+
+    /**
+     * Change the scope being overlaid, or stop overlaying with `nullptr`
+     */
+    void setParent(const PureScope *parent);
+    const PureScope *parent() const;
+
+    /**
+     * Discard all own variables and aliases, in constant time,
+     * uncovering what they have masked; the parent scope is kept
+     */
+    void reset();
+
+    /**
+     * Variables management:
+     * - assign the value to variable
+     * - discard the variable, masking the parent one until reset
+     * the name gets copied only when the variable is new,
+     * and the value gets copied into the memory the variable already owns,
+     * so assigning again after `reset` does not allocate once the memory suffices
+     * @return whether anything has changed
+     */
+    bool assignVariable(std::string_view name, std::string_view value);
+    bool discardVariable(std::string_view name);
+
+    /**
+     * Assign the value without copying it, so it points right into the caller memory;
+     * the memory must stay valid until the variable gets reassigned, discarded, or reset,
+     * which happens right after executing with `reset_on_finish`
+     * @return whether anything has changed
+     */
+    bool assignVariableView(std::string_view name, std::string_view value);
+
+    /**
+     * Alias management:
+     * - enable the alias
+     * - disable the alias, masking the parent one until reset
+     * @return whether anything has changed
+     */
+    bool enableAlias(std::string_view name);
+    bool disableAlias(std::string_view name);
+
+    /**
+     * Assign variables and aliases from the flat JSON object, like `{"name": "Anna", "number": 7, "vip": true}`:
+     * strings and numbers are assigned to variables, `null` discards the variable,
+     * and booleans enable or disable aliases;
+     * the JSON is read in place, so only names and values themselves get copied
+     * @return `false` if the JSON is broken, or is not the flat object, keeping the fields assigned before the broken place
+     */
+    bool assignJson(std::string_view json);
+
+    /**
+     * Same as `assignJson`, but the values point right into the JSON,
+     * so it must stay valid as for `assignVariableView`;
+     * only the strings having escapes get copied, being decoded
+     */
+    bool assignJsonView(std::string_view json);
+
+    /**
+     * Lookups check own variables and aliases at first, and then the parent scope;
+     * own discarded variables and disabled aliases are not looked up in the parent
+     */
+    std::optional<std::string_view> findVariable(std::string_view name) const override;
+    bool isAliasEnabled(std::string_view name) const override;
+
+private:
+    bool assignJson(std::string_view json, bool borrow_values);
+
+private:
+    /// Either the own copy of value, or the view into the caller memory
+    typedef std::variant<std::string, std::string_view> Value;
+
+    /// The entry is valid only within the generation it was assigned in;
+    /// the discarded one stays valid too, to mask the parent variable
+    struct Variable {
+        Value value;
+        uint64_t generation;
+        bool discarded;
+    };
+
+    /// Same for aliases, where the disabled one masks the parent alias
+    struct Alias {
+        uint64_t generation;
+        bool enabled;
+    };
+
+    /// Transparent comparing lets looking up by views without constructing strings
+    std::map<std::string, Variable, std::less<>> _variables;
+    std::map<std::string, Alias, std::less<>> _aliases;
+    uint64_t _generation = 1;
+    const PureScope *_parent;
+};
+
+#endif /* PureBindings_hpp */
@@ -0,0 +1,140 @@
+//
+//  PureBundle.cpp
+//  PureParser
+//
+//  Copyright © 2019 JivoSite Inc. All rights reserved.
+//  <For detailed info about how this parser works, please refer to README.md file>
+//
+
+#include "PureBundle.hpp"
+#include "PureUnicode.hpp"
+#include <fstream>
+#include <sstream>
+#include <cctype>
+
+static void skip_spaces_and_comments(std::string_view contents, size_t &offset);
+static bool read_quoted_string(std::string_view contents, size_t &offset, std::string &target);
+
+std::optional<PureBundle> PureBundle::parse(std::string_view contents, const PureParser &parser) {
+    PureBundle bundle;
+    std::string key, formula;
+
+    for (size_t offset = 0;;) {
+        skip_spaces_and_comments(contents, offset);
+        if (offset >= contents.size()) {
+            break;
+        }
+
+        // Every entry is `"key" = "formula";`
+        if (not read_quoted_string(contents, offset, key)) {
+            return std::nullopt;
+        }
+
+        skip_spaces_and_comments(contents, offset);
+        if (offset >= contents.size() || contents[offset++] != '=') {
+            return std::nullopt;
+        }
+
+        skip_spaces_and_comments(contents, offset);
+        if (not read_quoted_string(contents, offset, formula)) {
+            return std::nullopt;
+        }
+
+        skip_spaces_and_comments(contents, offset);
+        if (offset >= contents.size() || contents[offset++] != ';') {
+            return std::nullopt;
+        }
+
+        // The later entry with the same key wins
+        bundle._formulas.insert_or_assign(key, parser.compile(formula));
+    }
+
+    return bundle;
+}
+
+std::optional<PureBundle> PureBundle::load(const std::string &path, const PureParser &parser) {
+    std::ifstream stream(path, std::ios::in | std::ios::binary);
+    if (not stream) {
+        return std::nullopt;
+    }
+
+    std::ostringstream contents;
+    contents << stream.rdbuf();
+    if (stream.bad()) {
+        return std::nullopt;
+    }
+
+    return parse(contents.str(), parser);
+}
+
+const PureFormula *PureBundle::findFormula(std::string_view key) const {
+    const auto formula_iter = _formulas.find(key);
+    return (formula_iter == _formulas.end() ? nullptr : &formula_iter->second);
+}
+
+size_t PureBundle::size() const {
+    return _formulas.size();
+}
+
+static void skip_spaces_and_comments(std::string_view contents, size_t &offset) {
+    while (offset < contents.size()) {
+        const std::string_view rest = contents.substr(offset);
+        if (isspace(static_cast<unsigned char>(rest.front()))) {
+            offset++;
+        }
+        else if (rest.substr(0, 2) == "//") {
+            const size_t line_end = contents.find('\n', offset);
+            offset = (line_end == std::string_view::npos ? contents.size() : line_end + 1);
+        }
+        else if (rest.substr(0, 2) == "/*") {
+            const size_t comment_end = contents.find("*/", offset + 2);
+            offset = (comment_end == std::string_view::npos ? contents.size() : comment_end + 2);
+        }
+        else {
+            break;
+        }
+    }
+}
+
+static bool read_quoted_string(std::string_view contents, size_t &offset, std::string &target) {
+    if (offset >= contents.size() || contents[offset] != '"') {
+        return false;
+    }
+
+    target.clear();
+    for (offset++; offset < contents.size(); offset++) {
+        const char symbol = contents[offset];
+        if (symbol == '"') {
+            offset++;
+            return true;
+        }
+        else if (symbol != '\\') {
+            target.push_back(symbol);
+            continue;
+        }
+
+        if (++offset >= contents.size()) {
+            return false;
+        }
+
+        switch (contents[offset]) {
+            case 'n': target.push_back('\n'); break;
+            case 't': target.push_back('\t'); break;
+            case 'r': target.push_back('\r'); break;
+            case 'u': {
+                // Exactly four hex digits, with surrogate pairs joined
+                const size_t decoded_len = appendUnicodeEscape(contents.substr(offset + 1), target);
+                if (decoded_len == 0) {
+                    return false;
+                }
+
+                offset += decoded_len;
+                break;
+            }
+            default: target.push_back(contents[offset]); break;
+        }
+    }
+
+    // The closing quote is missing
+    return false;
+}
@@ -0,0 +1,49 @@
+//
+//  PureBundle.hpp
+//  PureParser
+//
+//  Copyright © 2019 JivoSite Inc. All rights reserved.
+//  <For detailed info about how this parser works, please refer to README.md file>
+//
+
+#ifndef PureBundle_hpp
+#define PureBundle_hpp
+
+#include "PureFormula.hpp"
+#include "PureParser.hpp"
+#include <string>
+#include <string_view>
+#include <map>
+#include <optional>
+#include <functional>
+
+/**
+ * The table of formulas compiled by keys,
+ * being read from the localization file of `"key" = "formula";` lines;
+ * line and block comments are skipped, and `\"`, `\\`, `\n`, `\t`, `\r`, `\uXXXX` escapes are supported
+ */
+class PureBundle {
+public:
+    /**
+     * Read the bundle from the contents, or the file at `path`,
+     * and compile every formula with the `parser` configuration;
+     * @return `std::nullopt` if the file cannot be read, or its syntax is broken
+     */
+    static std::optional<PureBundle> parse(std::string_view contents, const PureParser &parser);
+    static std::optional<PureBundle> load(const std::string &path, const PureParser &parser);
+
+    /**
+     * Get the compiled formula by key, or `nullptr` if there is no such key
+     */
+    const PureFormula *findFormula(std::string_view key) const;
+
+    /**
+     * The number of formulas
+     */
+    size_t size() const;
+
+private:
+    std::map<std::string, PureFormula, std::less<>> _formulas;
+};
+
+#endif /* PureBundle_hpp */
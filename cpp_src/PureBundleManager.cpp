@@ -0,0 +1,286 @@
+//
+//  PureBundleManager.cpp
+//  PureParser
+//
+//  Copyright © 2019 JivoSite Inc. All rights reserved.
+//  <For detailed info about how this parser works, please refer to README.md file>
+//
+
+#include "PureBundleManager.hpp"
+#include <set>
+#include <cerrno>
+#include <poll.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#if defined(__linux__)
+#include <sys/inotify.h>
+#endif
+
+/**
+ * The published bundles along with their files;
+ * the bundles are shared with the next snapshots until reloaded
+ */
+struct PureBundleManager::Snapshot {
+    struct Entry {
+        std::string path;
+        std::shared_ptr<const PureBundle> bundle;
+
+        /// The number of the load that started reading the file,
+        /// so that the older contents compiled slower never replace the newer ones
+        uint64_t load_number;
+    };
+
+    std::map<std::string, Entry, std::less<>> entries;
+};
+
+#pragma mark - Reader
+
+PureBundleManager::Reader::Reader(const PureBundleManager &manager)
+: _pin()
+, _snapshot(manager._current.load()) {
+}
+
+const PureBundle *PureBundleManager::Reader::findBundle(std::string_view name) const {
+    const auto entry_iter = _snapshot->entries.find(name);
+    return (entry_iter == _snapshot->entries.end() ? nullptr : entry_iter->second.bundle.get());
+}
+
+const PureFormula *PureBundleManager::Reader::findFormula(std::string_view name, std::string_view key) const {
+    const PureBundle *bundle = findBundle(name);
+    return (bundle ? bundle->findFormula(key) : nullptr);
+}
+
+#pragma mark - Manager
+
+PureBundleManager::PureBundleManager(const PureParser &parser)
+: _parser(parser)
+, _current(new Snapshot())
+, _loads_number(0)
+, _stop_descriptors { -1, -1 }
+, _reloads_number(0)
+, _failures_number(0) {
+}
+
+PureBundleManager::~PureBundleManager() {
+    stopWatching();
+
+    // Nobody may read while destroying, and the collector destroys the replaced snapshots
+    delete _current.load();
+}
+
+PureBundleManager::Reader PureBundleManager::read() const {
+    return Reader(*this);
+}
+
+bool PureBundleManager::add(const std::string &name, const std::string &path) {
+    return publish(name, path);
+}
+
+bool PureBundleManager::reload(std::string_view name) {
+    std::string path;
+    {
+        std::lock_guard<std::mutex> lock(_writer_mutex);
+        const Snapshot *snapshot = _current.load();
+        const auto entry_iter = snapshot->entries.find(name);
+        if (entry_iter == snapshot->entries.end()) {
+            return false;
+        }
+
+        path = entry_iter->second.path;
+    }
+
+    _reloads_number++;
+    if (publish(std::string(name), path)) {
+        return true;
+    }
+
+    _failures_number++;
+    return false;
+}
+
+bool PureBundleManager::publish(const std::string &name, const std::string &path) {
+    // Compiling takes a while, so the writers wait only for publishing;
+    // the number is taken before reading, so the later number means the newer contents
+    const uint64_t load_number = ++_loads_number;
+    std::optional<PureBundle> bundle = PureBundle::load(path, _parser);
+    if (not bundle.has_value()) {
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(_writer_mutex);
+    const auto entry_iter = _current.load()->entries.find(name);
+    if (entry_iter != _current.load()->entries.end() && entry_iter->second.load_number > load_number) {
+        return true;
+    }
+
+    Snapshot *snapshot = new Snapshot(*_current.load());
+    snapshot->entries.insert_or_assign(name, Snapshot::Entry {
+        path,
+        std::make_shared<const PureBundle>(std::move(*bundle)),
+        load_number
+    });
+
+    _collector.retire(_current.exchange(snapshot));
+    return true;
+}
+
+bool PureBundleManager::startWatching() {
+    if (_watcher.joinable()) {
+        return true;
+    }
+
+    // Fail right here if the files cannot be watched
+    int events_descriptor = -1;
+#if defined(__linux__)
+    events_descriptor = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (events_descriptor < 0) {
+        return false;
+    }
+#endif
+
+    if (pipe(_stop_descriptors) != 0) {
+        _stop_descriptors[0] = _stop_descriptors[1] = -1;
+        if (events_descriptor >= 0) {
+            close(events_descriptor);
+        }
+
+        return false;
+    }
+
+    std::map<std::string, std::string> paths;
+    {
+        std::lock_guard<std::mutex> lock(_writer_mutex);
+        for (const auto &entry : _current.load()->entries) {
+            paths.emplace(entry.first, entry.second.path);
+        }
+    }
+
+    _watcher = std::thread(&PureBundleManager::watch, this, std::move(paths), events_descriptor, _stop_descriptors[0]);
+    return true;
+}
+
+void PureBundleManager::stopWatching() {
+    if (not _watcher.joinable()) {
+        return;
+    }
+
+    const char stop_signal = 0;
+    while (write(_stop_descriptors[1], &stop_signal, 1) < 0 && errno == EINTR) {
+    }
+
+    _watcher.join();
+    close(_stop_descriptors[0]);
+    close(_stop_descriptors[1]);
+    _stop_descriptors[0] = _stop_descriptors[1] = -1;
+}
+
+size_t PureBundleManager::reloadsNumber() const {
+    return _reloads_number.load();
+}
+
+size_t PureBundleManager::failuresNumber() const {
+    return _failures_number.load();
+}
+
+#if defined(__linux__)
+
+void PureBundleManager::watch(std::map<std::string, std::string> paths, int inotify_descriptor, int stop_descriptor) {
+    // Editors often replace the file instead of writing it, so its directory is watched
+    std::map<int, std::multimap<std::string, std::string>> names_by_watch;
+    for (const auto &path : paths) {
+        const size_t separator_position = path.second.rfind('/');
+        const std::string directory = (separator_position == std::string::npos ? "." : path.second.substr(0, separator_position + 1));
+        const std::string filename = (separator_position == std::string::npos ? path.second : path.second.substr(separator_position + 1));
+
+        const int watch_descriptor = inotify_add_watch(inotify_descriptor, directory.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO);
+        if (watch_descriptor >= 0) {
+            names_by_watch[watch_descriptor].emplace(filename, path.first);
+        }
+    }
+
+    alignas(struct inotify_event) char buffer[4096];
+    for (;;) {
+        struct pollfd descriptors[2] = {
+            { inotify_descriptor, POLLIN, 0 },
+            { stop_descriptor, POLLIN, 0 }
+        };
+
+        if (poll(descriptors, 2, -1) < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+
+            break;
+        }
+
+        if (descriptors[1].revents != 0) {
+            break;
+        }
+
+        // Gather all the pending events first, so the file written in several steps gets reloaded once
+        std::set<std::string> changed_names;
+        for (;;) {
+            const ssize_t length = ::read(inotify_descriptor, buffer, sizeof(buffer));
+            if (length <= 0) {
+                break;
+            }
+
+            for (ssize_t offset = 0; offset < length;) {
+                const struct inotify_event *event = reinterpret_cast<const struct inotify_event *>(buffer + offset);
+                offset += sizeof(struct inotify_event) + event->len;
+
+                const auto names_iter = names_by_watch.find(event->wd);
+                if (names_iter == names_by_watch.end() || event->len == 0) {
+                    continue;
+                }
+
+                const auto range = names_iter->second.equal_range(event->name);
+                for (auto name_iter = range.first; name_iter != range.second; ++name_iter) {
+                    changed_names.insert(name_iter->second);
+                }
+            }
+        }
+
+        for (const auto &name : changed_names) {
+            reload(name);
+        }
+    }
+
+    close(inotify_descriptor);
+}
+
+#else
+
+/// How often the files get checked where they cannot be watched
+static const int kPureBundlePollingInterval = 1000;
+
+void PureBundleManager::watch(std::map<std::string, std::string> paths, int, int stop_descriptor) {
+    const auto modification_time = [](const std::string &path) {
+        struct stat file_stat;
+        return (stat(path.c_str(), &file_stat) == 0 ? file_stat.st_mtime : 0);
+    };
+
+    std::map<std::string, time_t> times;
+    for (const auto &path : paths) {
+        times[path.first] = modification_time(path.second);
+    }
+
+    for (;;) {
+        struct pollfd descriptor = { stop_descriptor, POLLIN, 0 };
+        const int polled = poll(&descriptor, 1, kPureBundlePollingInterval);
+        if (polled > 0 || (polled < 0 && errno != EINTR)) {
+            break;
+        }
+
+        for (const auto &path : paths) {
+            const time_t time = modification_time(path.second);
+            if (time != times[path.first]) {
+                times[path.first] = time;
+                reload(path.first);
+            }
+        }
+    }
+}
+
+#endif
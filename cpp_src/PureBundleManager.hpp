@@ -0,0 +1,117 @@
+//
+//  PureBundleManager.hpp
+//  PureParser
+//
+//  Copyright © 2019 JivoSite Inc. All rights reserved.
+//  <For detailed info about how this parser works, please refer to README.md file>
+//
+
+#ifndef PureBundleManager_hpp
+#define PureBundleManager_hpp
+
+#include "PureBundle.hpp"
+#include "PureParser.hpp"
+#include "PureEpoch.hpp"
+#include <string>
+#include <string_view>
+#include <map>
+#include <memory>
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+
+/**
+ * The bundles by names, reloaded from their files while rendering keeps going:
+ * - the watching thread notices the changed files (by inotify on Linux, by modification time elsewhere),
+ *   and compiles them in the background
+ * - the new bundle gets published at once, and renders in progress keep the old one
+ * - the old bundle is destroyed once no reader remains
+ */
+class PureBundleManager {
+private:
+    struct Snapshot;
+
+public:
+    /**
+     * The bundles as they were published when the reader was created;
+     * keep it only while rendering, otherwise the replaced bundles cannot be destroyed
+     */
+    class Reader {
+    public:
+        explicit Reader(const PureBundleManager &manager);
+
+        /**
+         * Get the bundle by name, or `nullptr` if there is no such bundle
+         */
+        const PureBundle *findBundle(std::string_view name) const;
+
+        /**
+         * Get the formula by key within the named bundle, or `nullptr` if there is no such bundle or key
+         */
+        const PureFormula *findFormula(std::string_view name, std::string_view key) const;
+
+    private:
+        PureEpochPin _pin;
+        const Snapshot *_snapshot;
+    };
+
+    /**
+     * Create the manager compiling the bundles with the `parser` configuration
+     */
+    explicit PureBundleManager(const PureParser &parser);
+    ~PureBundleManager();
+
+    PureBundleManager(const PureBundleManager&) = delete;
+    PureBundleManager &operator=(const PureBundleManager&) = delete;
+
+    /**
+     * Pin the current bundles for reading
+     */
+    Reader read() const;
+
+    /**
+     * Load the bundle from the file at `path` and publish it by `name`, replacing the previous one;
+     * if the file was read again meanwhile and its newer contents got published first, they are kept
+     * @return `false` if the file cannot be read, or its syntax is broken, keeping the previous bundle
+     */
+    bool add(const std::string &name, const std::string &path);
+
+    /**
+     * Load the named bundle from its file again, the same way the watching thread does;
+     * @return `false` if there is no such bundle, or the file cannot be read, keeping the previous bundle
+     */
+    bool reload(std::string_view name);
+
+    /**
+     * Start the thread watching the files of bundles added so far, or stop it;
+     * the bundles added while watching get watched after restarting
+     * @return `false` if watching cannot be started, like when inotify is not available
+     */
+    bool startWatching();
+    void stopWatching();
+
+    /**
+     * The number of reloads by now, succeeded and failed
+     */
+    size_t reloadsNumber() const;
+    size_t failuresNumber() const;
+
+private:
+    bool publish(const std::string &name, const std::string &path);
+    void watch(std::map<std::string, std::string> paths, int events_descriptor, int stop_descriptor);
+
+private:
+    const PureParser _parser;
+    std::atomic<const Snapshot*> _current;
+    mutable std::mutex _writer_mutex;
+    std::atomic<uint64_t> _loads_number;
+    PureEpochCollector _collector;
+
+    std::thread _watcher;
+    int _stop_descriptors[2];
+    std::atomic<size_t> _reloads_number;
+    std::atomic<size_t> _failures_number;
+};
+
+#endif /* PureBundleManager_hpp */
@@ -13,6 +13,7 @@
 #include <list>
 #include <optional>
 #include <variant>
+#include <utility>
 
 enum PureElementType {
     /// `payload` is the alias name;
@@ -39,14 +40,8 @@ struct PureElement {
 
     PureElement(PureElementType type, std::string payload = std::string(), std::list<PureElement> children = {}) {
         this->type = type;
-        this->payload = payload;
-        this->children = children;
-    }
-
-    PureElement(const PureElement &other) {
-        this->type = other.type;
-        this->payload = other.payload;
-        this->children = other.children;
+        this->payload = std::move(payload);
+        this->children = std::move(children);
     }
 };
 
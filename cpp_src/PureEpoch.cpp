@@ -0,0 +1,130 @@
+//
+//  PureEpoch.cpp
+//  PureParser
+//
+//  Copyright © 2019 JivoSite Inc. All rights reserved.
+//  <For detailed info about how this parser works, please refer to README.md file>
+//
+
+#include "PureEpoch.hpp"
+#include <atomic>
+#include <mutex>
+#include <set>
+#include <limits>
+
+/// The slot epoch of thread which is not reading now
+static const uint64_t kPureEpochIdle = 0;
+
+/**
+ * The epoch the thread has started reading within;
+ * only the owner thread writes here
+ */
+struct PureEpochSlot {
+    std::atomic<uint64_t> epoch { kPureEpochIdle };
+};
+
+/**
+ * All the slots of threads being alive, and the global epoch;
+ * readers take the mutex only when their thread reads for the first time
+ */
+struct PureEpochRegistry {
+    std::mutex mutex;
+    std::set<const PureEpochSlot*> slots;
+    std::atomic<uint64_t> epoch { kPureEpochIdle + 1 };
+};
+
+static PureEpochRegistry &shared_registry();
+
+/**
+ * Registers the slot of current thread on first use,
+ * and counts the nested pins, so that only the outermost one changes the slot
+ */
+class PureEpochSlotHolder {
+public:
+    PureEpochSlotHolder() {
+        PureEpochRegistry &registry = shared_registry();
+        std::lock_guard<std::mutex> lock(registry.mutex);
+        registry.slots.insert(&slot);
+    }
+
+    ~PureEpochSlotHolder() {
+        PureEpochRegistry &registry = shared_registry();
+        std::lock_guard<std::mutex> lock(registry.mutex);
+        registry.slots.erase(&slot);
+    }
+
+    PureEpochSlot slot;
+    size_t depth = 0;
+};
+
+static thread_local PureEpochSlotHolder current_slot_holder;
+
+#pragma mark - Pin
+
+PureEpochPin::PureEpochPin() {
+    // Announce the epoch before looking at the objects,
+    // so the writer either sees the reader, or the reader sees the newer objects
+    if (current_slot_holder.depth++ == 0) {
+        current_slot_holder.slot.epoch.store(shared_registry().epoch.load());
+    }
+}
+
+PureEpochPin::~PureEpochPin() {
+    if (--current_slot_holder.depth == 0) {
+        current_slot_holder.slot.epoch.store(kPureEpochIdle, std::memory_order_release);
+    }
+}
+
+#pragma mark - Collector
+
+PureEpochCollector::~PureEpochCollector() {
+    // Nobody may read while destroying
+    for (const auto &retired : _retired) {
+        retired.destroy(retired.object);
+    }
+}
+
+void PureEpochCollector::retire(const void *object, void (*destroy)(const void *object)) {
+    // Readers pinning within the next epoch cannot see the object anymore
+    const uint64_t epoch = shared_registry().epoch.fetch_add(1);
+    _retired.push_back(Retired { object, destroy, epoch });
+
+    collect();
+}
+
+void PureEpochCollector::collect() {
+    // Find the oldest epoch somebody is still reading within
+    uint64_t oldest_epoch = std::numeric_limits<uint64_t>::max();
+    {
+        PureEpochRegistry &registry = shared_registry();
+        std::lock_guard<std::mutex> lock(registry.mutex);
+        for (const PureEpochSlot *slot : registry.slots) {
+            const uint64_t epoch = slot->epoch.load();
+            if (epoch != kPureEpochIdle && epoch < oldest_epoch) {
+                oldest_epoch = epoch;
+            }
+        }
+    }
+
+    // The object retired within some epoch is only seen by readers pinned within it or earlier
+    size_t kept_number = 0;
+    for (const auto &retired : _retired) {
+        if (retired.epoch < oldest_epoch) {
+            retired.destroy(retired.object);
+        }
+        else {
+            _retired[kept_number++] = retired;
+        }
+    }
+
+    _retired.resize(kept_number);
+}
+
+size_t PureEpochCollector::retiredNumber() const {
+    return _retired.size();
+}
+
+static PureEpochRegistry &shared_registry() {
+    static PureEpochRegistry registry;
+    return registry;
+}
@@ -0,0 +1,77 @@
+//
+//  PureEpoch.hpp
+//  PureParser
+//
+//  Copyright © 2019 JivoSite Inc. All rights reserved.
+//  <For detailed info about how this parser works, please refer to README.md file>
+//
+
+#ifndef PureEpoch_hpp
+#define PureEpoch_hpp
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+/**
+ * Keeps the objects published for reading by other threads alive while they are read:
+ * - readers pin the current epoch for a while, without locking
+ * - writers retire the replaced objects, along with the epoch they were replaced within
+ * - retired objects get destroyed once every pinned reader has started after that epoch
+ */
+class PureEpochPin {
+public:
+    /**
+     * Pin the current epoch for the thread, before looking at the published objects;
+     * nested pins keep the outermost epoch
+     */
+    PureEpochPin();
+    ~PureEpochPin();
+
+    PureEpochPin(const PureEpochPin&) = delete;
+    PureEpochPin &operator=(const PureEpochPin&) = delete;
+};
+
+/**
+ * The objects retired by the single writer, or by writers serialized by their own lock
+ */
+class PureEpochCollector {
+public:
+    PureEpochCollector() = default;
+    ~PureEpochCollector();
+
+    PureEpochCollector(const PureEpochCollector&) = delete;
+    PureEpochCollector &operator=(const PureEpochCollector&) = delete;
+
+    /**
+     * Retire the object which is not published anymore,
+     * and destroy the retired objects nobody reads anymore
+     */
+    template <typename Object>
+    void retire(const Object *object) {
+        retire(object, [](const void *retired_object) { delete static_cast<const Object *>(retired_object); });
+    }
+
+    void retire(const void *object, void (*destroy)(const void *object));
+
+    /**
+     * Destroy the retired objects nobody reads anymore
+     */
+    void collect();
+
+    /**
+     * The number of retired objects still waiting for readers to leave them
+     */
+    size_t retiredNumber() const;
+
+private:
+    struct Retired {
+        const void *object;
+        void (*destroy)(const void *object);
+        uint64_t epoch;
+    };
+
+    std::vector<Retired> _retired;
+};
+
+#endif /* PureEpoch_hpp */
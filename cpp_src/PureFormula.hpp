@@ -0,0 +1,32 @@
+//
+//  PureFormula.hpp
+//  PureParser
+//
+//  Copyright © 2019 JivoSite Inc. All rights reserved.
+//  <For detailed info about how this parser works, please refer to README.md file>
+//
+
+#ifndef PureFormula_hpp
+#define PureFormula_hpp
+
+#include "PureElement.hpp"
+#include <string>
+#include <utility>
+
+/**
+ * The formula that was recognized once,
+ * and can be executed many times later without scanning again
+ */
+struct PureFormula {
+    /// The original textual formula
+    std::string source;
+
+    /// The root frame the formula was recognized into
+    PureElement root;
+
+    PureFormula(std::string source, PureElement root)
+    : source(std::move(source)), root(std::move(root)) {
+    }
+};
+
+#endif /* PureFormula_hpp */
@@ -0,0 +1,309 @@
+//
+//  PureJson.cpp
+//  PureParser
+//
+//  Copyright © 2019 JivoSite Inc. All rights reserved.
+//  <For detailed info about how this parser works, please refer to README.md file>
+//
+
+#include "PureJson.hpp"
+#include "PureUnicode.hpp"
+#include <cstring>
+
+static bool is_number(std::string_view value);
+
+PureJsonReader::PureJsonReader(std::string_view json)
+: _json(json) {
+    this->_offset = 0;
+    this->_closer = '}';
+    this->_started = false;
+    this->_finished = false;
+    this->_failed = false;
+}
+
+bool PureJsonReader::next(PureJsonField &field) {
+    if (_finished || _failed) {
+        return false;
+    }
+
+    skipSpaces();
+    if (not _started) {
+        _started = true;
+        if (_offset < _json.size() && (_json[_offset] == '{' || _json[_offset] == '[')) {
+            _closer = (_json[_offset++] == '{' ? '}' : ']');
+        }
+        else {
+            return fail();
+        }
+
+        skipSpaces();
+        if (_offset < _json.size() && _json[_offset] == _closer) {
+            _offset++;
+            _finished = true;
+        }
+    }
+    else if (_offset < _json.size() && _json[_offset] == ',') {
+        _offset++;
+        skipSpaces();
+    }
+    else if (_offset < _json.size() && _json[_offset] == _closer) {
+        _offset++;
+        _finished = true;
+    }
+    else {
+        return fail();
+    }
+
+    // Only spaces may follow the object
+    if (_finished) {
+        skipSpaces();
+        return (_offset == _json.size() ? false : fail());
+    }
+
+    // Array items have no names
+    if (_closer == ']') {
+        field.name = std::string_view();
+    }
+    else if (not readString(field.name, _name_buffer)) {
+        return fail();
+    }
+    else {
+        skipSpaces();
+        if (_offset >= _json.size() || _json[_offset++] != ':') {
+            return fail();
+        }
+
+        skipSpaces();
+    }
+
+    if (_offset >= _json.size()) {
+        return fail();
+    }
+    else if (_json[_offset] == '"') {
+        field.type = PureJsonTypeString;
+        return readString(field.value, _value_buffer) || fail();
+    }
+    else if (_json[_offset] == '{' || _json[_offset] == '[') {
+        return readNested(field) || fail();
+    }
+    else {
+        return readLiteral(field) || fail();
+    }
+}
+
+bool PureJsonReader::failed() const {
+    return _failed;
+}
+
+bool PureJsonReader::pointsIntoJson(std::string_view piece) const {
+    return (piece.data() >= _json.data() && piece.data() + piece.size() <= _json.data() + _json.size());
+}
+
+bool PureJsonReader::fail() {
+    _failed = true;
+    return false;
+}
+
+void PureJsonReader::skipSpaces() {
+    while (_offset < _json.size() && strchr(" \t\r\n", _json[_offset]) != nullptr && _json[_offset] != 0x00) {
+        _offset++;
+    }
+}
+
+bool PureJsonReader::skipString(bool &escaped) {
+    // Jump between quotes and backslashes instead of checking every symbol
+    escaped = false;
+
+    // The quote found is kept until some escape consumes it, so the string is scanned once
+    size_t quote_offset = std::string_view::npos;
+    for (size_t offset = _offset + 1; offset < _json.size();) {
+        if (quote_offset == std::string_view::npos) {
+            const char *quote = static_cast<const char *>(memchr(_json.data() + offset, '"', _json.size() - offset));
+            if (quote == nullptr) {
+                return false;
+            }
+
+            quote_offset = quote - _json.data();
+        }
+
+        const char *backslash = static_cast<const char *>(memchr(_json.data() + offset, '\\', quote_offset - offset));
+        if (backslash) {
+            // The escaped symbol cannot be the closing quote
+            escaped = true;
+            offset = (backslash - _json.data()) + 2;
+            if (offset > quote_offset) {
+                quote_offset = std::string_view::npos;
+            }
+
+            continue;
+        }
+
+        _offset = quote_offset + 1;
+        return true;
+    }
+
+    return false;
+}
+
+bool PureJsonReader::readString(std::string_view &target, std::string &buffer) {
+    const size_t start = _offset + 1;
+    bool escaped = false;
+
+    if (_offset >= _json.size() || _json[_offset] != '"' || not skipString(escaped)) {
+        return false;
+    }
+
+    const std::string_view raw = _json.substr(start, _offset - 1 - start);
+    if (not escaped) {
+        target = raw;
+        return true;
+    }
+    else if (decodeString(raw, buffer)) {
+        target = buffer;
+        return true;
+    }
+    else {
+        return false;
+    }
+}
+
+bool PureJsonReader::readNested(PureJsonField &field) {
+    const size_t start = _offset;
+    field.type = (_json[_offset] == '{' ? PureJsonTypeObject : PureJsonTypeArray);
+
+    // Only match the brackets, and leave the contents to the nested reader
+    size_t depth = 0;
+    bool escaped = false;
+
+    while (_offset < _json.size()) {
+        const char symbol = _json[_offset];
+        if (symbol == '"') {
+            if (not skipString(escaped)) {
+                return false;
+            }
+
+            continue;
+        }
+        else if (symbol == '{' || symbol == '[') {
+            depth++;
+        }
+        else if ((symbol == '}' || symbol == ']') && --depth == 0) {
+            _offset++;
+            field.value = _json.substr(start, _offset - start);
+            return true;
+        }
+
+        _offset++;
+    }
+
+    return false;
+}
+
+bool PureJsonReader::readLiteral(PureJsonField &field) {
+    const size_t start = _offset;
+    while (_offset < _json.size() && strchr(",}] \t\r\n", _json[_offset]) == nullptr && _json[_offset] != 0x00) {
+        _offset++;
+    }
+
+    field.value = _json.substr(start, _offset - start);
+    if (field.value == "true") {
+        field.type = PureJsonTypeTrue;
+    }
+    else if (field.value == "false") {
+        field.type = PureJsonTypeFalse;
+    }
+    else if (field.value == "null") {
+        field.type = PureJsonTypeNull;
+    }
+    else if (is_number(field.value)) {
+        field.type = PureJsonTypeNumber;
+    }
+    else {
+        return false;
+    }
+
+    return true;
+}
+
+bool PureJsonReader::decodeString(std::string_view raw, std::string &target) {
+    target.clear();
+
+    for (size_t offset = 0; offset < raw.size(); offset++) {
+        if (raw[offset] != '\\') {
+            target.push_back(raw[offset]);
+            continue;
+        }
+
+        if (++offset >= raw.size()) {
+            return false;
+        }
+
+        switch (raw[offset]) {
+            case '"': target.push_back('"'); break;
+            case '\\': target.push_back('\\'); break;
+            case '/': target.push_back('/'); break;
+            case 'b': target.push_back('\b'); break;
+            case 'f': target.push_back('\f'); break;
+            case 'n': target.push_back('\n'); break;
+            case 'r': target.push_back('\r'); break;
+            case 't': target.push_back('\t'); break;
+            case 'u': {
+                const size_t decoded_len = appendUnicodeEscape(raw.substr(offset + 1), target);
+                if (decoded_len == 0) {
+                    return false;
+                }
+
+                offset += decoded_len;
+                break;
+            }
+            default:
+                return false;
+        }
+    }
+
+    return true;
+}
+
+static bool is_number(std::string_view value) {
+    // As JSON defines it: -?(0|[1-9][0-9]*)(.[0-9]+)?([eE][+-]?[0-9]+)?
+    size_t offset = 0;
+    const auto skip_digits = [&]() {
+        const size_t start = offset;
+        while (offset < value.size() && value[offset] >= '0' && value[offset] <= '9') {
+            offset++;
+        }
+
+        return offset - start;
+    };
+
+    if (offset < value.size() && value[offset] == '-') {
+        offset++;
+    }
+
+    if (offset < value.size() && value[offset] == '0') {
+        offset++;
+    }
+    else if (skip_digits() == 0) {
+        return false;
+    }
+
+    if (offset < value.size() && value[offset] == '.') {
+        offset++;
+        if (skip_digits() == 0) {
+            return false;
+        }
+    }
+
+    if (offset < value.size() && (value[offset] == 'e' || value[offset] == 'E')) {
+        offset++;
+        if (offset < value.size() && (value[offset] == '+' || value[offset] == '-')) {
+            offset++;
+        }
+
+        if (skip_digits() == 0) {
+            return false;
+        }
+    }
+
+    return (offset == value.size());
+}
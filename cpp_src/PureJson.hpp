@@ -0,0 +1,86 @@
+//
+//  PureJson.hpp
+//  PureParser
+//
+//  Copyright © 2019 JivoSite Inc. All rights reserved.
+//  <For detailed info about how this parser works, please refer to README.md file>
+//
+
+#ifndef PureJson_hpp
+#define PureJson_hpp
+
+#include <string>
+#include <string_view>
+
+/**
+ * The type of flat JSON value
+ */
+enum PureJsonType {
+    PureJsonTypeString,
+    PureJsonTypeNumber,
+    PureJsonTypeTrue,
+    PureJsonTypeFalse,
+    PureJsonTypeNull,
+    PureJsonTypeObject,
+    PureJsonTypeArray
+};
+
+/**
+ * The single field of JSON object, or the item of JSON array having no name;
+ * for strings, `value` is the text without quotes,
+ * for other types, it is the text as written, including nested objects and arrays
+ */
+struct PureJsonField {
+    std::string_view name;
+    std::string_view value;
+    PureJsonType type;
+};
+
+/**
+ * The reader of JSON object, like `{"name": "Anna", "number": 7, "vip": true}`, or array,
+ * going field by field without building any tree, and without descending into nested values;
+ * names and values point right into the JSON text,
+ * and only the strings having escapes get decoded into the reader own buffers
+ */
+class PureJsonReader {
+public:
+    explicit PureJsonReader(std::string_view json);
+
+    /**
+     * Read the next field, valid until the next call;
+     * @return `false` when the object is over, or the JSON is broken, see `failed`
+     */
+    bool next(PureJsonField &field);
+
+    /**
+     * Whether the JSON is broken
+     */
+    bool failed() const;
+
+    /**
+     * Whether the name or value points right into the JSON,
+     * rather than into the reader buffers being reused for decoding
+     */
+    bool pointsIntoJson(std::string_view piece) const;
+
+private:
+    bool fail();
+    void skipSpaces();
+    bool skipString(bool &escaped);
+    bool readString(std::string_view &target, std::string &buffer);
+    bool readNested(PureJsonField &field);
+    bool readLiteral(PureJsonField &field);
+    static bool decodeString(std::string_view raw, std::string &target);
+
+private:
+    std::string_view _json;
+    size_t _offset;
+    char _closer;
+    bool _started;
+    bool _finished;
+    bool _failed;
+    std::string _name_buffer;
+    std::string _value_buffer;
+};
+
+#endif /* PureJson_hpp */
@@ -0,0 +1,197 @@
+//
+//  PureOutput.cpp
+//  PureParser
+//
+//  Copyright © 2019 JivoSite Inc. All rights reserved.
+//  <For detailed info about how this parser works, please refer to README.md file>
+//
+
+#include "PureOutput.hpp"
+#include "PureStatistics.hpp"
+#include "PureTracing.hpp"
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+#include <utility>
+
+static bool is_space_symbol(char symbol);
+static bool is_punctuation_symbol(char symbol);
+
+PureCollapsingOutput::PureCollapsingOutput(PureOutput &target)
+: _target(target) {
+    this->_pending_space = nullptr;
+    this->_anything_written = false;
+    this->_input_len = 0;
+    this->_output_len = 0;
+
+    PURE_TRACE_POINT(PureTracePhaseCollapse, PureTraceStageBegin, 0, 0);
+}
+
+void PureCollapsingOutput::write(std::string_view piece) {
+    PURE_PHASE_SCOPE(PurePhaseCollapse);
+    _input_len += piece.size();
+
+    const char *iter = piece.data();
+    const char *end = piece.data() + piece.size();
+
+    while (iter < end) {
+        // Within the spaces, remember only the last one;
+        // it would replace the entire spaces sequence later, if needed
+        if (is_space_symbol(*iter)) {
+            while (iter < end && is_space_symbol(*iter)) {
+                _pending_space = iter++;
+            }
+
+            continue;
+        }
+
+        // The spaces are dropped at the beginning, and before the punctuation;
+        // otherwise, the last one of them is kept
+        if (_pending_space && _anything_written && not is_punctuation_symbol(*iter)) {
+            _target.write(std::string_view(_pending_space, 1));
+            _output_len++;
+        }
+
+        // Pass all the valuable symbols at once
+        const char *valuable_begin = iter;
+        while (iter < end && not is_space_symbol(*iter)) {
+            iter++;
+        }
+
+        _target.write(std::string_view(valuable_begin, iter - valuable_begin));
+        _output_len += iter - valuable_begin;
+        _pending_space = nullptr;
+        _anything_written = true;
+    }
+}
+
+void PureCollapsingOutput::finish() {
+    // The trailing spaces are dropped
+    _pending_space = nullptr;
+    _target.finish();
+
+    PURE_TRACE_POINT(PureTracePhaseCollapse, PureTraceStageEnd, _input_len, _output_len);
+}
+
+PureChunkedOutput::PureChunkedOutput(Consumer consumer, std::string &buffer, size_t buffer_capacity)
+: _consumer(std::move(consumer)), _buffer(buffer) {
+    this->_buffer_capacity = buffer_capacity;
+    this->_passed_len = 0;
+    this->_buffer.clear();
+}
+
+void PureChunkedOutput::write(std::string_view piece) {
+    if (piece.empty()) {
+        return;
+    }
+
+    // Make sure the buffer would not grow over its capacity
+    if (_buffer.size() + piece.size() > _buffer_capacity) {
+        flush();
+    }
+
+    // The long piece goes as is, without copying into the buffer
+    if (piece.size() >= _buffer_capacity) {
+        _consumer(piece);
+        _passed_len += piece.size();
+    }
+    else {
+        _buffer.append(piece.data(), piece.size());
+    }
+}
+
+void PureChunkedOutput::finish() {
+    flush();
+}
+
+size_t PureChunkedOutput::passedLength() const {
+    return _passed_len;
+}
+
+void PureChunkedOutput::flush() {
+    if (not _buffer.empty()) {
+        _consumer(_buffer);
+        _passed_len += _buffer.size();
+        _buffer.clear();
+    }
+}
+
+PureStringOutput::PureStringOutput(std::string &target)
+: _target(target) {
+}
+
+void PureStringOutput::write(std::string_view piece) {
+    _target.append(piece.data(), piece.size());
+}
+
+void PureStringOutput::finish() {
+}
+
+PureBufferOutput::PureBufferOutput(char *buffer, size_t capacity) {
+    this->_buffer = buffer;
+    this->_capacity = capacity;
+    this->_required_len = 0;
+}
+
+void PureBufferOutput::write(std::string_view piece) {
+    // Copy as much as fits, and keep counting the rest
+    if (_required_len < _capacity) {
+        const size_t fitting_len = std::min(piece.size(), _capacity - _required_len);
+        memcpy(_buffer + _required_len, piece.data(), fitting_len);
+    }
+
+    _required_len += piece.size();
+}
+
+void PureBufferOutput::finish() {
+}
+
+size_t PureBufferOutput::requiredLength() const {
+    return _required_len;
+}
+
+PureVectorOutput::PureVectorOutput(std::vector<struct iovec> &target)
+: _target(target) {
+    this->_collected_len = 0;
+}
+
+void PureVectorOutput::write(std::string_view piece) {
+    if (piece.empty()) {
+        return;
+    }
+
+    _collected_len += piece.size();
+
+    // Extend the last `iovec` if the piece follows it right in memory,
+    // e.g. the collapsing output split the slice at spaces
+    if (not _target.empty()) {
+        struct iovec &last_vector = _target.back();
+        if (static_cast<const char *>(last_vector.iov_base) + last_vector.iov_len == piece.data()) {
+            last_vector.iov_len += piece.size();
+            return;
+        }
+    }
+
+    _target.push_back(iovec {
+        .iov_base = const_cast<char *>(piece.data()),
+        .iov_len = piece.size()
+    });
+}
+
+void PureVectorOutput::finish() {
+}
+
+size_t PureVectorOutput::collectedLength() const {
+    return _collected_len;
+}
+
+static bool is_space_symbol(char symbol) {
+    return isspace(symbol);
+}
+
+static bool is_punctuation_symbol(char symbol) {
+    switch (symbol) {
+        case '.': case '?': case '!': case ';': case ':': case ',': return true;
+        default: return false;
+    }
+}
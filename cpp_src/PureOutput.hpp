@@ -0,0 +1,146 @@
+//
+//  PureOutput.hpp
+//  PureParser
+//
+//  Copyright © 2019 JivoSite Inc. All rights reserved.
+//  <For detailed info about how this parser works, please refer to README.md file>
+//
+
+#ifndef PureOutput_hpp
+#define PureOutput_hpp
+
+#include <string>
+#include <string_view>
+#include <functional>
+#include <vector>
+#include <sys/uio.h>
+
+/**
+ * The destination for the output being produced piece by piece;
+ * pieces point right into the compiled formula and the assigned values,
+ * so they stay valid until the execution is finished
+ */
+class PureOutput {
+public:
+    virtual ~PureOutput() = default;
+
+    /**
+     * Accept the next piece of the output
+     * @param piece the contents to append
+     */
+    virtual void write(std::string_view piece) = 0;
+
+    /**
+     * Inform the output has ended
+     */
+    virtual void finish() = 0;
+};
+
+/**
+ * The output that removes extra spaces on the fly
+ * the same way the parser does it for the entire output,
+ * and passes the remaining pieces into the `target` output
+ */
+class PureCollapsingOutput: public PureOutput {
+public:
+    explicit PureCollapsingOutput(PureOutput &target);
+
+    void write(std::string_view piece) override;
+    void finish() override;
+
+private:
+    PureOutput &_target;
+    const char *_pending_space;
+    bool _anything_written;
+    size_t _input_len;
+    size_t _output_len;
+};
+
+/**
+ * The output that passes the pieces into the `consumer` by chunks;
+ * short pieces are gathered together in the buffer of `buffer_capacity` bytes,
+ * while the longer ones are passed as is;
+ * the buffer is provided from outside, to reuse its memory between executions
+ */
+class PureChunkedOutput: public PureOutput {
+public:
+    typedef std::function<void(std::string_view chunk)> Consumer;
+
+    PureChunkedOutput(Consumer consumer, std::string &buffer, size_t buffer_capacity);
+
+    void write(std::string_view piece) override;
+    void finish() override;
+
+    /**
+     * How many bytes have been passed so far
+     */
+    size_t passedLength() const;
+
+private:
+    void flush();
+
+private:
+    Consumer _consumer;
+    std::string &_buffer;
+    size_t _buffer_capacity;
+    size_t _passed_len;
+};
+
+/**
+ * The output that appends all the pieces to the `target` string
+ */
+class PureStringOutput: public PureOutput {
+public:
+    explicit PureStringOutput(std::string &target);
+
+    void write(std::string_view piece) override;
+    void finish() override;
+
+private:
+    std::string &_target;
+};
+
+/**
+ * The output that writes the pieces into the fixed `buffer` of `capacity` bytes;
+ * whatever does not fit is dropped, but still counted in the required length
+ */
+class PureBufferOutput: public PureOutput {
+public:
+    PureBufferOutput(char *buffer, size_t capacity);
+
+    void write(std::string_view piece) override;
+    void finish() override;
+
+    /**
+     * How many bytes the entire output takes
+     */
+    size_t requiredLength() const;
+
+private:
+    char *_buffer;
+    size_t _capacity;
+    size_t _required_len;
+};
+
+/**
+ * The output that collects the pieces as `iovec` list, ready to be passed into `writev`;
+ * the adjacent pieces get merged into one `iovec`
+ */
+class PureVectorOutput: public PureOutput {
+public:
+    explicit PureVectorOutput(std::vector<struct iovec> &target);
+
+    void write(std::string_view piece) override;
+    void finish() override;
+
+    /**
+     * How many bytes have been collected so far
+     */
+    size_t collectedLength() const;
+
+private:
+    std::vector<struct iovec> &_target;
+    size_t _collected_len;
+};
+
+#endif /* PureOutput_hpp */
@@ -8,7 +8,9 @@
 
 #include "PureParser.hpp"
 #include "PureScanner.hpp"
-#include <regex>
+#include "PureStatistics.hpp"
+#include "PureProfiler.hpp"
+#include "PureTracing.hpp"
 #include <iostream>
 #include <optional>
 #include <list>
@@ -26,53 +28,151 @@ PureParser::PureParser(PureConfig config) {
 }
 
 void PureParser::reset() {
-    _assigned_variables.clear();
-    _enabled_aliases.clear();
+    _bindings.reset();
 }
 
-void PureParser::assignVariable(std::string name, std::string value) {
-    _assigned_variables.insert_or_assign(name, value);
+void PureParser::assignVariable(std::string_view name, std::string_view value) {
+    _bindings.assignVariable(name, value);
 }
 
-void PureParser::discardVariable(std::string name) {
-    _assigned_variables.erase(name);
+void PureParser::discardVariable(std::string_view name) {
+    _bindings.discardVariable(name);
 }
 
-void PureParser::enableAlias(std::string name) {
-    _enabled_aliases.insert(name);
+void PureParser::assignVariableView(std::string_view name, std::string_view value) {
+    _bindings.assignVariableView(name, value);
 }
 
-void PureParser::disableAlias(std::string name) {
-    _enabled_aliases.erase(name);
+void PureParser::enableAlias(std::string_view name) {
+    _bindings.enableAlias(name);
+}
+
+void PureParser::disableAlias(std::string_view name) {
+    _bindings.disableAlias(name);
+}
+
+bool PureParser::assignJson(std::string_view json) {
+    return _bindings.assignJson(json);
+}
+
+bool PureParser::assignJsonView(std::string_view json) {
+    return _bindings.assignJsonView(json);
+}
+
+void PureParser::setParentScope(const PureScope *scope) {
+    _bindings.setParent(scope);
 }
 
 std::string PureParser::execute(std::string formula, bool collapse_spaces, bool reset_on_finish) {
-    // Parse the entire formula like a root frame into a tree
+    PureStatisticsScope statistics_scope(PureCounterExecutes, formula);
+    return execute(compile(std::move(formula)), collapse_spaces, reset_on_finish);
+}
+
+PureFormula PureParser::compile(std::string formula) const {
+    PureStatisticsScope statistics_scope(PureCounterCompiles, formula);
+    PURE_PHASE_SCOPE(PurePhaseRecognize);
+    PURE_TRACE_FORMULA_SCOPE(trace_scope, PureTracePhaseRecognize, formula, formula.size());
+
+    // Parse the entire formula like a root frame into a tree,
+    // or use an empty frame if something went wrong
     size_t frame_len = 0;
-    const std::optional<PureElement> frame = recognizeFrame(formula, &frame_len);
+    std::optional<PureElement> frame = recognizeFrame(formula, &frame_len);
+    if (frame.has_value()) {
+        return PureFormula(std::move(formula), std::move(*frame));
+    }
+    else {
+        return PureFormula(std::move(formula), PureElement(PureElementTypeFrame));
+    }
+}
+
+std::string PureParser::execute(const PureFormula &formula, bool collapse_spaces, bool reset_on_finish) {
+    std::string output;
+    execute(formula, collapse_spaces, reset_on_finish, output);
+    return output;
+}
 
-    // Resolve the tree into the output,
-    // or use empty string if something went wrong
-    std::string result = frame.has_value()
-        ? resolveFrame(*frame).value_or(std::string())
-        : std::string();
+void PureParser::execute(const PureFormula &formula, bool collapse_spaces, bool reset_on_finish, std::string &output) {
+    execute(formula, _bindings, collapse_spaces, output);
 
     // Whether we should discard all variables and alises
     // right after the formula was executed; in preparing for next execution
     if (reset_on_finish) {
         reset();
     }
+}
 
-    // Whether we should remove all extra spaces from the output
-    if (collapse_spaces) {
-        return removeExtraSpaces(result);
+void PureParser::execute(const PureFormula &formula, bool collapse_spaces, bool reset_on_finish, size_t buffer_capacity, PureChunkedOutput::Consumer consumer) {
+    PureStatisticsScope statistics_scope(PureCounterExecutes, formula.source);
+    PURE_TRACE_FORMULA_SCOPE(trace_scope, PureTracePhaseResolve, formula.source, formula.source.size());
+
+    // Pass the output by chunks while variables are still assigned
+    PureChunkedOutput output(std::move(consumer), _chunk_buffer, buffer_capacity);
+    writeOutput(formula, _bindings, collapse_spaces, output);
+    statistics_scope.addOutputBytes(output.passedLength());
+    PURE_TRACE_OUTPUT(trace_scope, output.passedLength());
+
+    // Whether we should discard all variables and alises
+    // right after the formula was executed; in preparing for next execution
+    if (reset_on_finish) {
+        reset();
     }
-    else {
-        return result;
+}
+
+void PureParser::execute(const PureFormula &formula, bool collapse_spaces, std::vector<struct iovec> &vectors) {
+    // Collect the output pieces without copying them;
+    // variables cannot be reset here, since vectors point to their values
+    PureStatisticsScope statistics_scope(PureCounterExecutes, formula.source);
+    PURE_TRACE_FORMULA_SCOPE(trace_scope, PureTracePhaseResolve, formula.source, formula.source.size());
+
+    vectors.clear();
+    PureVectorOutput output(vectors);
+    writeOutput(formula, _bindings, collapse_spaces, output);
+    statistics_scope.addOutputBytes(output.collectedLength());
+    PURE_TRACE_OUTPUT(trace_scope, output.collectedLength());
+}
+
+size_t PureParser::execute(const PureFormula &formula, bool collapse_spaces, bool reset_on_finish, char *buffer, size_t capacity) {
+    const size_t output_len = execute(formula, _bindings, collapse_spaces, buffer, capacity);
+
+    // Keep everything for the next attempt if the output did not fit
+    if (reset_on_finish && output_len <= capacity) {
+        reset();
     }
+
+    return output_len;
+}
+
+std::string PureParser::execute(const PureFormula &formula, const PureScope &scope, bool collapse_spaces) const {
+    std::string output;
+    execute(formula, scope, collapse_spaces, output);
+    return output;
+}
+
+void PureParser::execute(const PureFormula &formula, const PureScope &scope, bool collapse_spaces, std::string &output) const {
+    PureStatisticsScope statistics_scope(PureCounterExecutes, formula.source);
+    PURE_TRACE_FORMULA_SCOPE(trace_scope, PureTracePhaseResolve, formula.source, formula.source.size());
+
+    // Write the output right into the string, keeping its capacity
+    output.clear();
+    PureStringOutput string_output(output);
+    writeOutput(formula, scope, collapse_spaces, string_output);
+    statistics_scope.addOutputBytes(output.size());
+    PURE_TRACE_OUTPUT(trace_scope, output.size());
 }
 
-std::optional<PureElement> PureParser::recognizeFrame(std::string input, size_t *scanned_len) {
+size_t PureParser::execute(const PureFormula &formula, const PureScope &scope, bool collapse_spaces, char *buffer, size_t capacity) const {
+    PureStatisticsScope statistics_scope(PureCounterExecutes, formula.source);
+    PURE_TRACE_FORMULA_SCOPE(trace_scope, PureTracePhaseResolve, formula.source, formula.source.size());
+
+    PureBufferOutput output(buffer, capacity);
+    writeOutput(formula, scope, collapse_spaces, output);
+    statistics_scope.addOutputBytes(output.requiredLength());
+    PURE_TRACE_OUTPUT(trace_scope, output.requiredLength());
+
+    return output.requiredLength();
+}
+
+std::optional<PureElement> PureParser::recognizeFrame(std::string input, size_t *scanned_len) const {
     PureScanner scanner(input);
     std::list<PureElement> children_elements;
     std::optional<std::string> alias_name;
@@ -125,7 +225,7 @@ std::optional<PureElement> PureParser::recognizeFrame(std::string input, size_t
 
                 // If an element has been recognized, place it into children elements
                 if (element.has_value()) {
-                    children_elements.push_back(*element);
+                    children_elements.push_back(std::move(*element));
                     scanner.skipBy(element_len);
                 }
                 // Otherwise, place just the element token itself into children elements
@@ -140,7 +240,7 @@ std::optional<PureElement> PureParser::recognizeFrame(std::string input, size_t
                 const std::string payload = alias_name.value_or(std::string());
                 children_elements.emplace_back(PureElementTypeSlice, scanner.last_slice);
                 *scanned_len += scanner.last_slice.length();
-                return PureElement(PureElementTypeFrame, payload, children_elements);
+                return PureElement(PureElementTypeFrame, payload, std::move(children_elements));
             }
             // No especial tokens were found, so just continue looking
             else {
@@ -160,10 +260,10 @@ std::optional<PureElement> PureParser::recognizeFrame(std::string input, size_t
     const std::string payload = alias_name.value_or(std::string());
     children_elements.emplace_back(PureElementTypeSlice, scanner.following_slice);
     *scanned_len += scanner.following_slice.length();
-    return PureElement(PureElementTypeFrame, payload, children_elements);
+    return PureElement(PureElementTypeFrame, payload, std::move(children_elements));
 }
 
-std::optional<PureElement> PureParser::recognizeElement(std::string input, size_t *scanned_len) {
+std::optional<PureElement> PureParser::recognizeElement(std::string input, size_t *scanned_len) const {
     // First, try to recognize the element as block
     std::optional<PureElement> element = recognizeBlockElement(input, scanned_len);
     if (element.has_value()) {
@@ -180,9 +280,9 @@ std::optional<PureElement> PureParser::recognizeElement(std::string input, size_
     return std::nullopt;
 }
 
-std::optional<PureElement> PureParser::recognizeBlockElement(std::string input, size_t *scanned_len) {
+std::optional<PureElement> PureParser::recognizeBlockElement(std::string input, size_t *scanned_len) const {
     // If input does not start with block opener token, it's not the block
-    if (input.find(_config.block_opener_token) != 0) {
+    if (input.compare(0, _config.block_opener_token.length(), _config.block_opener_token) != 0) {
         return std::nullopt;
     }
 
@@ -212,7 +312,7 @@ std::optional<PureElement> PureParser::recognizeBlockElement(std::string input,
         // If frame is correct, append in into block frames
         // and point the scanner into place after this frame
         if (frame.has_value() && frame_len > 0) {
-            block_frames.push_back(*frame);
+            block_frames.push_back(std::move(*frame));
             scanner.skipBy(frame_len);
         }
 
@@ -228,10 +328,10 @@ std::optional<PureElement> PureParser::recognizeBlockElement(std::string input,
         }
     }
 
-    return PureElement(PureElementTypeBlock, std::string(), block_frames);
+    return PureElement(PureElementTypeBlock, std::string(), std::move(block_frames));
 }
 
-std::optional<PureElement> PureParser::recognizeVariableElement(std::string input, size_t *scanned_len) {
+std::optional<PureElement> PureParser::recognizeVariableElement(std::string input, size_t *scanned_len) const {
     // Allowed symbols are: letters, digits, underscore
     const auto isAllowedSymbol = [](char symbol) -> bool {
         return (isalpha(symbol) || isdigit(symbol) || (symbol == '_'));
@@ -266,111 +366,113 @@ std::optional<PureElement> PureParser::recognizeVariableElement(std::string inpu
     return PureElement(PureElementTypeVariable, input);
 }
 
-std::optional<std::string> PureParser::resolveFrame(const PureElement &frame) {
-    // If the frame has alias, and this alias is not activated,
-    // the frame should be skipped as invalid
-    const std::string alias = frame.payload;
-    if (not alias.empty() && _enabled_aliases.find(alias) == _enabled_aliases.end()) {
-        return std::nullopt;
-    }
+void PureParser::writeOutput(const PureFormula &formula, const PureScope &scope, bool collapse_spaces, PureOutput &output) const {
+    PURE_PHASE_SCOPE(PurePhaseResolve);
 
-    // To resolve a frame,
-    // we need to join all its valid elements into single output
-    std::string output;
-    for (const auto &element : frame.children) {
-        const std::optional<std::string> element_output = resolveElement(element);
-        if (element_output.has_value()) {
-            output += *element_output;
-        }
-        // But, if any children element is invalid,
-        // the entire frame has to be invalid as well
-        else {
-            return std::nullopt;
-        }
+    // Whether we should remove all extra spaces on the fly
+    if (collapse_spaces) {
+        PureCollapsingOutput collapsing_output(output);
+        writeOutput(formula, scope, false, collapsing_output);
+        return;
     }
 
-    return output;
-}
+    // The inactive root frame produces the empty output
+    if (isFrameActive(formula.root, scope)) {
+        writeFrame(formula.root, scope, output);
+    }
 
-std::optional<std::string> PureParser::resolveSlice(const PureElement &slice) {
-    // To resolve a slice,
-    // we just have to return its contents
-    return slice.payload;
+    output.finish();
 }
 
-std::optional<std::string> PureParser::resolveElement(const PureElement &element) {
-    // Resolve the element in a proper way
-    // accordingly to its type
-    switch (element.type) {
-        case PureElementTypeFrame: return resolveFrame(element);
-        case PureElementTypeBlock: return resolveBlockElement(element);
-        case PureElementTypeVariable: return resolveVariableElement(element);
-        case PureElementTypeSlice: return resolveSlice(element);
+void PureParser::writeFrame(const PureElement &frame, const PureScope &scope, PureOutput &output) const {
+    // The frame is known to be active here,
+    // so just write all its elements one by one
+    for (const auto &element : frame.children) {
+        switch (element.type) {
+            case PureElementTypeFrame:
+                writeFrame(element, scope, output);
+                break;
+
+            case PureElementTypeBlock:
+                writeBlockElement(element, scope, output);
+                break;
+
+            case PureElementTypeVariable:
+                output.write(*scope.findVariable(element.payload));
+                break;
+
+            case PureElementTypeSlice:
+                output.write(element.payload);
+                break;
+        }
     }
 }
 
-std::optional<std::string> PureParser::resolveBlockElement(const PureElement &block) {
-    // To resolve a block,
-    // we need return its first valid element
-    for (const auto &element : block.children) {
-        const std::optional<std::string> element_output = resolveElement(element);
-        if (element_output.has_value()) {
-            return *element_output;
+void PureParser::writeBlockElement(const PureElement &block, const PureScope &scope, PureOutput &output) const {
+    // To write a block,
+    // we need to choose its first active element
+    const PureElement *chosen_frame = nullptr;
+    size_t frames_tried = 0;
+    {
+        PURE_TRACE_SCOPE(trace_scope, PureTracePhaseBlock, block.children.size());
+        for (const auto &element : block.children) {
+            frames_tried++;
+            if (isFrameActive(element, scope)) {
+                chosen_frame = &element;
+                break;
+            }
+            else if (PureProfiler::isEnabled()) {
+                PureProfiler::recordRejectedFrame(describeFrame(element));
+            }
         }
-    }
-    
-    // If no valid element was found, use the empty string
-    return std::string();
-}
 
-std::optional<std::string> PureParser::resolveVariableElement(const PureElement &variable) {
-    // To resolve a block,
-    // we need to obtain its assigned value at first
-    const std::string variable_name = variable.payload;
-    const auto variable_iter = _assigned_variables.find(variable_name);
+        PURE_TRACE_OUTPUT(trace_scope, frames_tried);
+    }
 
-    // If the value is not assigned, the variable is invalid;
-    // otherwise, it is
-    if (variable_iter == _assigned_variables.end()) {
-        return std::nullopt;
+    if (chosen_frame) {
+        writeFrame(*chosen_frame, scope, output);
     }
-    else {
-        return variable_iter->second;
+
+    if (PureStatistics::isEnabled()) {
+        PureStatistics::count(PureCounterBlocks, 1);
+        PureStatistics::count(PureCounterFramesTried, frames_tried);
+        PureStatistics::count(PureCounterFramesAccepted, chosen_frame ? 1 : 0);
     }
 }
 
-std::string PureParser::removeExtraSpaces(std::string string) {
-    // RegEx to remove the double spaces from within the output
-    const std::regex collapse_expr("\\s+(?:(\\s|[.?!;:,])|$)");
-    std::smatch collapse_match;
-
-    // Keep in loop while the next processed output differs from its input
-    std::string collapsed = string;
-    while (true) {
-        const std::string result = std::regex_replace(collapsed, collapse_expr, "$1");
-        if (result == collapsed) break;
-        collapsed = result;
+bool PureParser::isFrameActive(const PureElement &frame, const PureScope &scope) const {
+    // The frame is inactive if it has the alias not being enabled
+    const std::string &alias = frame.payload;
+    if (not alias.empty() && not scope.isAliasEnabled(alias)) {
+        return false;
     }
 
-    // Return the output without leading and trailing extra spaces
-    const auto _spaceDetector = [](int symbol) -> bool {
-        return std::isspace(symbol);
-    };
-    
-    const auto front_begin = collapsed.cbegin();
-    const auto front_end = collapsed.cend();
-    const auto front_iter = std::find_if_not(front_begin, front_end, _spaceDetector);
-    
-    const auto back_begin = collapsed.crbegin();
-    const auto back_end = collapsed.crend();
-    const auto back_iter = std::find_if_not(back_begin, back_end, _spaceDetector).base();
-    
-    if (front_iter < back_iter) {
-        return std::string(front_iter, back_iter);
+    // Also, the frame is inactive if any its variable is not assigned;
+    // blocks are always valid, even if they produce nothing
+    for (const auto &element : frame.children) {
+        if (element.type == PureElementTypeVariable && not scope.findVariable(element.payload).has_value()) {
+            return false;
+        }
     }
-    else {
-        return std::string();
+
+    return true;
+}
+
+std::string PureParser::describeFrame(const PureElement &frame) const {
+    // Describe the frame by its alias and variables,
+    // since these are what make it inactive
+    std::string description;
+    if (not frame.payload.empty()) {
+        description = _config.alias_token + frame.payload + _config.alias_token;
     }
+
+    for (const auto &element : frame.children) {
+        if (element.type == PureElementTypeVariable) {
+            description += (description.empty() ? "" : " ") + _config.element_token + element.payload;
+        }
+    }
+
+    return description;
 }
 
 static bool is_valuable_symbol(char symbol) {
@@ -10,11 +10,16 @@
 #define PureParser_hpp
 
 #include "PureElement.hpp"
+#include "PureFormula.hpp"
+#include "PureOutput.hpp"
+#include "PureBindings.hpp"
 #include <string>
+#include <string_view>
 #include <map>
 #include <set>
 #include <utility>
 #include <optional>
+#include <vector>
 
 /**
  * By default, the config
@@ -58,41 +63,109 @@ public:
      * Variables management:
      * - assign the value to variable
      * - discard the variable
+     * names are taken by views, and get copied only when the variable is new
      */
-    void assignVariable(std::string name, std::string value);
-    void discardVariable(std::string name);
+    void assignVariable(std::string_view name, std::string_view value);
+    void discardVariable(std::string_view name);
+
+    /**
+     * Assign the value without copying it, see `PureBindings::assignVariableView`;
+     * with `reset_on_finish`, the value is only used by the next execute
+     */
+    void assignVariableView(std::string_view name, std::string_view value);
 
     /**
      * Alias management:
      * - enable the alias
      * - discard the alias
      */
-    void enableAlias(std::string name);
-    void disableAlias(std::string name);
+    void enableAlias(std::string_view name);
+    void disableAlias(std::string_view name);
+
+    /**
+     * Assign variables and aliases from the flat JSON object, see `PureBindings::assignJson`;
+     * the view variant keeps the values pointing into the JSON
+     */
+    bool assignJson(std::string_view json);
+    bool assignJsonView(std::string_view json);
+
+    /**
+     * Overlay the long-lived scope, e.g. the tenant `PureBindings`, or stop it with `nullptr`:
+     * what is not assigned to the parser gets looked up there,
+     * and resetting the parser keeps it; the scope must outlive the parser
+     */
+    void setParentScope(const PureScope *scope);
 
     /**
      * Execute the formula with previously assigned variables and aliases
      */
     std::string execute(std::string formula, bool collapse_spaces, bool reset_on_finish);
 
+    /**
+     * Recognize the formula once, to execute it many times later
+     */
+    PureFormula compile(std::string formula) const;
+
+    /**
+     * Execute the compiled formula with previously assigned variables and aliases
+     */
+    std::string execute(const PureFormula &formula, bool collapse_spaces, bool reset_on_finish);
+
+    /**
+     * Execute the compiled formula into the `output` string, keeping its capacity;
+     * being called again and again with the same string, it does not allocate memory
+     */
+    void execute(const PureFormula &formula, bool collapse_spaces, bool reset_on_finish, std::string &output);
+
+    /**
+     * Execute the compiled formula, and pass the output into `consumer` by chunks instead of concatenating it;
+     * chunks point right into the compiled formula and assigned values,
+     * while the short ones are gathered together in the buffer of `buffer_capacity` bytes
+     */
+    void execute(const PureFormula &formula, bool collapse_spaces, bool reset_on_finish, size_t buffer_capacity, PureChunkedOutput::Consumer consumer);
+
+    /**
+     * Execute the compiled formula into the `iovec` list, ready to be passed into `writev`;
+     * vectors point right into the compiled formula and assigned values,
+     * so they stay valid until the formula is destroyed or the variables are changed
+     */
+    void execute(const PureFormula &formula, bool collapse_spaces, std::vector<struct iovec> &vectors);
+
+    /**
+     * Execute the compiled formula right into the `buffer` of `capacity` bytes, without allocating memory;
+     * returns the length of the entire output, and if it exceeds the `capacity`, the output is truncated
+     * and nothing gets reset, so the formula can be executed again into the larger buffer
+     */
+    size_t execute(const PureFormula &formula, bool collapse_spaces, bool reset_on_finish, char *buffer, size_t capacity);
+
+    /**
+     * Execute the compiled formula with the given scope, e.g. `PureBindings`, instead of assigned variables and aliases;
+     * these do not change the parser, so they can be called from many threads at once,
+     * same as `compile`, while nobody changes the parser and the scope
+     */
+    std::string execute(const PureFormula &formula, const PureScope &scope, bool collapse_spaces) const;
+    void execute(const PureFormula &formula, const PureScope &scope, bool collapse_spaces, std::string &output) const;
+    size_t execute(const PureFormula &formula, const PureScope &scope, bool collapse_spaces, char *buffer, size_t capacity) const;
+
 private:
-    std::optional<PureElement> recognizeFrame(std::string input, size_t *scanned_len);
-    std::optional<PureElement> recognizeElement(std::string input, size_t *scanned_len);
-    std::optional<PureElement> recognizeBlockElement(std::string input, size_t *scanned_len);
-    std::optional<PureElement> recognizeVariableElement(std::string input, size_t *scanned_len);
+    friend class PureSession;
+    friend class PureStreamParser;
 
-    std::optional<std::string> resolveFrame(const PureElement &frame);
-    std::optional<std::string> resolveSlice(const PureElement &slice);
-    std::optional<std::string> resolveElement(const PureElement &element);
-    std::optional<std::string> resolveBlockElement(const PureElement &block);
-    std::optional<std::string> resolveVariableElement(const PureElement &variable);
+    std::optional<PureElement> recognizeFrame(std::string input, size_t *scanned_len) const;
+    std::optional<PureElement> recognizeElement(std::string input, size_t *scanned_len) const;
+    std::optional<PureElement> recognizeBlockElement(std::string input, size_t *scanned_len) const;
+    std::optional<PureElement> recognizeVariableElement(std::string input, size_t *scanned_len) const;
 
-    std::string removeExtraSpaces(std::string string);
+    void writeOutput(const PureFormula &formula, const PureScope &scope, bool collapse_spaces, PureOutput &output) const;
+    void writeFrame(const PureElement &frame, const PureScope &scope, PureOutput &output) const;
+    void writeBlockElement(const PureElement &block, const PureScope &scope, PureOutput &output) const;
+    bool isFrameActive(const PureElement &frame, const PureScope &scope) const;
+    std::string describeFrame(const PureElement &frame) const;
 
 private:
     PureConfig _config;
-    std::map<std::string, std::string> _assigned_variables;
-    std::set<std::string> _enabled_aliases;
+    PureBindings _bindings;
+    std::string _chunk_buffer;
 };
 
 #endif /* PureParser_hpp */
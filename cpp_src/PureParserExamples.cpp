@@ -3,11 +3,24 @@
 //
 
 #include "PureParser.hpp"
+#include "PureSession.hpp"
+#include "PureStreamParser.hpp"
+#include "PureStatistics.hpp"
+#include "PureProfiler.hpp"
+#include "PureTracing.hpp"
+#include "PureBindings.hpp"
+#include "PureBundle.hpp"
+#include "PureBundleManager.hpp"
+#include "PureSharedBindings.hpp"
+#include "PureSharedTable.hpp"
 #include <string>
 #include <map>
 #include <set>
 #include <vector>
 #include <iostream>
+#include <cstdio>
+#include <fstream>
+#include <algorithm>
 
 #pragma mark - Local Types
 
@@ -193,6 +206,664 @@ static example_meta_t test_Coupons() {
     };
 }
 
+static example_meta_t test_SessionRefresh() {
+    PureSession session;
+    const std::string formula = "$[Agent $creatorName ## You] changed reminder $[:target: for $[$targetName ## you]]";
+
+    session.enableAlias("target");
+    const size_t output_id = session.attach(formula, true);
+    const size_t unrelated_id = session.attach("Hello, $name", true);
+
+    session.assignVariable("targetName", "Paul");
+    const std::vector<size_t> changed_ids = session.refresh();
+
+    const std::string output = (changed_ids == std::vector<size_t>{ output_id }) ? session.output(output_id) : session.output(unrelated_id);
+    const std::string reference = "You changed reminder for Paul";
+
+    return example_meta_t {
+        .formula = formula,
+        .variables = std::map<std::string, std::string>{ {"targetName", "Paul"} },
+        .aliases = std::set<std::string>{ "target" },
+        .reference = reference,
+        .output = output
+    };
+}
+
+static example_meta_t test_StreamedFormula() {
+    PureParser parser;
+    const std::string formula = "$[Agent $creatorName ## You] changed reminder $[«$comment»] $[:target: for $[$targetName ## you]] on $date at $time";
+
+    std::list<PureElement> elements;
+    PureStreamParser stream_parser([&](const PureElement &element) { elements.push_back(element); });
+    for (size_t offset = 0; offset < formula.length(); offset += 5) {
+        stream_parser.feed(std::string_view(formula).substr(offset, 5));
+    }
+    stream_parser.finish();
+
+    parser.assignVariable("comment", "Check his payment");
+    parser.assignVariable("date", "today");
+    parser.assignVariable("time", "11:30 AM");
+    parser.enableAlias("target");
+
+    const PureFormula streamed_formula(formula, PureElement(PureElementTypeFrame, stream_parser.alias(), elements));
+    const std::string output = parser.execute(streamed_formula, true, true);
+    const std::string reference = "You changed reminder «Check his payment» for you on today at 11:30 AM";
+
+    return example_meta_t {
+        .formula = formula,
+        .variables = std::map<std::string, std::string>{ {"comment", "Check his payment"}, {"date", "today"}, {"time", "11:30 AM"} },
+        .aliases = std::set<std::string>{ "target" },
+        .reference = reference,
+        .output = output
+    };
+}
+
+static example_meta_t test_ChunkedOutput() {
+    PureParser parser;
+    const PureFormula formula = parser.compile("$[$name has ## You have] $[$number coupon(s) ## no coupons]   expiring on $date");
+
+    parser.assignVariable("number", "7");
+    parser.assignVariable("date", "11/11/19");
+
+    std::string output;
+    parser.execute(formula, true, true, 8, [&](std::string_view chunk) { output.append(chunk); });
+    const std::string reference = "You have 7 coupon(s) expiring on 11/11/19";
+
+    return example_meta_t {
+        .formula = formula.source,
+        .variables = std::map<std::string, std::string>{ {"number", "7"}, {"date", "11/11/19"} },
+        .aliases = std::set<std::string>(),
+        .reference = reference,
+        .output = output
+    };
+}
+
+static example_meta_t test_VectoredOutput() {
+    PureParser parser;
+    const PureFormula formula = parser.compile("Congrats!   You saved it $[in folder '$folder'] .");
+
+    parser.assignVariable("folder", "Documents");
+
+    std::vector<struct iovec> vectors;
+    parser.execute(formula, true, vectors);
+
+    std::string output;
+    for (const auto &vector : vectors) {
+        output.append(static_cast<const char *>(vector.iov_base), vector.iov_len);
+    }
+
+    const std::string reference = "Congrats! You saved it in folder 'Documents'.";
+
+    return example_meta_t {
+        .formula = formula.source,
+        .variables = std::map<std::string, std::string>{ {"folder", "Documents"} },
+        .aliases = std::set<std::string>(),
+        .reference = reference,
+        .output = output
+    };
+}
+
+static example_meta_t test_RuntimeStatistics() {
+    PureStatistics::setEnabled(true);
+    PureStatistics::reset();
+
+    PureParser parser;
+    parser.assignVariable("number", "7");
+    const std::string formula = "Coupons: $[$count of $total ## $number ## none]";
+    const std::string result = parser.execute(formula, true, false);
+
+    // The first frame lacks the variable, so two frames get tried
+    const PureStatisticsSnapshot snapshot = PureStatistics::snapshot();
+    PureStatistics::setEnabled(false);
+
+    const std::string output = result
+        + " / executes=" + std::to_string(snapshot.counters[PureCounterExecutes])
+        + " bytes=" + std::to_string(snapshot.counters[PureCounterOutputBytes])
+        + " frames=" + std::to_string(snapshot.counters[PureCounterFramesAccepted]) + "/" + std::to_string(snapshot.counters[PureCounterFramesTried])
+        + " timings=" + std::to_string(snapshot.histograms[PureHistogramExecute].count);
+
+    const std::string reference = "Coupons: 7 / executes=1 bytes=10 frames=1/2 timings=1";
+
+    return example_meta_t {
+        .formula = formula,
+        .variables = std::map<std::string, std::string>{ {"number", "7"} },
+        .aliases = std::set<std::string>(),
+        .reference = reference,
+        .output = output
+    };
+}
+
+static example_meta_t test_FormulaProfile() {
+    PureProfiler::setEnabled(true);
+    PureProfiler::reset();
+
+    PureParser parser;
+    parser.assignVariable("number", "7");
+    const std::string formula = "Coupons: $[:vip:$number for you ## $number ## none]";
+    parser.execute(formula, true, false);
+    const std::string result = parser.execute(formula, true, false);
+
+    // The frame with disabled alias gets rejected every time
+    const std::vector<PureFormulaProfile> profiles = PureProfiler::snapshot();
+    PureProfiler::setEnabled(false);
+
+    const PureFormulaProfile &profile = profiles.front();
+    const auto rejected_frame = profile.mostRejectedFrames(1).front();
+    const std::string output = result
+        + " / calls=" + std::to_string(profile.calls)
+        + " avg=" + std::to_string(int(profile.averageOutput()))
+        + " rejected=" + rejected_frame.first + " x" + std::to_string(rejected_frame.second);
+
+    const std::string reference = "Coupons: 7 / calls=2 avg=10 rejected=:vip: $number x2";
+
+    return example_meta_t {
+        .formula = formula,
+        .variables = std::map<std::string, std::string>{ {"number", "7"} },
+        .aliases = std::set<std::string>(),
+        .reference = reference,
+        .output = output
+    };
+}
+
+static example_meta_t test_ProfileEviction() {
+    PureProfiler::setEnabled(true);
+    PureProfiler::reset();
+    PureProfiler::setCapacity(2);
+
+    // The third formula evicts the one called fewer times
+    PureParser parser;
+    const std::string formula = "Hello, $[$name ## guest]";
+    for (const auto &execution : std::vector<std::pair<std::string, int>>{ {formula, 3}, {"Bye, $name", 2}, {"Hi, $name", 1} }) {
+        for (int call = 0; call < execution.second; call++) {
+            parser.execute(execution.first, true, true);
+        }
+    }
+
+    std::vector<PureFormulaProfile> profiles = PureProfiler::snapshot();
+    PureProfiler::setCapacity(kPureProfilerDefaultCapacity);
+    PureProfiler::setEnabled(false);
+
+    std::sort(profiles.begin(), profiles.end(), [](const PureFormulaProfile &first, const PureFormulaProfile &second) {
+        return first.calls > second.calls;
+    });
+
+    std::string output = parser.execute(formula, true, true);
+    for (const auto &profile : profiles) {
+        output += " / " + profile.formula + " x" + std::to_string(profile.calls);
+    }
+
+    const std::string reference = "Hello, guest / Hello, $[$name ## guest] x3 / Hi, $name x1";
+
+    return example_meta_t {
+        .formula = formula,
+        .variables = std::map<std::string, std::string>(),
+        .aliases = std::set<std::string>(),
+        .reference = reference,
+        .output = output
+    };
+}
+
+static example_meta_t test_TracePoints() {
+    const char * const phase_captions[] = { "recognize", "resolve", "block", "collapse" };
+    std::string trace;
+    PureTracer::setCallback([&](const PureTracePoint &point) {
+        trace += (point.stage == PureTraceStageBegin ? "+" : "-") + std::string(phase_captions[point.phase]);
+        trace += (point.stage == PureTraceStageEnd ? "(" + std::to_string(point.output_len) + ") " : " ");
+    });
+
+    PureParser parser;
+    parser.assignVariable("number", "7");
+    const std::string formula = "Coupons:  $[$count ## $number]";
+    const std::string result = parser.execute(formula, true, false);
+    PureTracer::setCallback(nullptr);
+
+    // Without tracing built in, no points are emitted at all
+    const std::string reference = PureTracer::isEnabled()
+        ? "+recognize -recognize(0) +resolve +collapse +block -block(2) -collapse(10) -resolve(10) "
+        : "";
+
+    return example_meta_t {
+        .formula = formula,
+        .variables = std::map<std::string, std::string>{ {"number", "7"} },
+        .aliases = std::set<std::string>(),
+        .reference = reference,
+        .output = trace
+    };
+}
+
+static example_meta_t test_SharedFormulaBindings() {
+    const PureParser parser;
+    const PureFormula formula = parser.compile("$[$name has ## You have] $[$number coupon(s) ## no coupons] expiring on $date");
+
+    // Each caller keeps its own bindings, while the parser and the formula are shared
+    PureBindings first_bindings;
+    first_bindings.assignVariable("name", "Anna");
+    first_bindings.assignVariable("date", "11/11/19");
+
+    PureBindings second_bindings;
+    second_bindings.assignVariable("number", "7");
+    second_bindings.assignVariable("date", "11/11/19");
+
+    const std::string first_output = parser.execute(formula, first_bindings, true);
+    const std::string output = parser.execute(formula, second_bindings, true);
+    const std::string reference = "You have 7 coupon(s) expiring on 11/11/19";
+
+    return example_meta_t {
+        .formula = formula.source,
+        .variables = std::map<std::string, std::string>{ {"number", "7"}, {"date", "11/11/19"} },
+        .aliases = std::set<std::string>(),
+        .reference = reference,
+        .output = (first_output == "Anna has no coupons expiring on 11/11/19" ? output : first_output)
+    };
+}
+
+static example_meta_t test_BundleFormulas() {
+    const PureParser parser;
+    const std::optional<PureBundle> bundle = PureBundle::parse(
+        "/* Notifications */\n"
+        "\"coupons\" = \"$[$name has ## You have] $[$number coupon(s) ## no coupons] expiring on $date\";\n"
+        "// Greeting\n"
+        "\"greeting\" = \"Hi, \\\"$name\\\"\";\n",
+        parser);
+
+    PureBindings bindings;
+    bindings.assignVariable("number", "7");
+    bindings.assignVariable("date", "11/11/19");
+
+    const PureFormula *formula = (bundle.has_value() && bundle->size() == 2 ? bundle->findFormula("coupons") : nullptr);
+    const std::string output = (formula ? parser.execute(*formula, bindings, true) : std::string());
+    const std::string reference = "You have 7 coupon(s) expiring on 11/11/19";
+
+    return example_meta_t {
+        .formula = (formula ? formula->source : std::string()),
+        .variables = std::map<std::string, std::string>{ {"number", "7"}, {"date", "11/11/19"} },
+        .aliases = std::set<std::string>(),
+        .reference = reference,
+        .output = output
+    };
+}
+
+static example_meta_t test_BundleEscapes() {
+    const PureParser parser;
+
+    // Escapes take exactly four hex digits, and surrogate pairs make the single character
+    const std::optional<PureBundle> bundle = PureBundle::parse("\"smile\" = \"$name \\ud83d\\ude00\\u00e9\";", parser);
+    const bool rejected = (not PureBundle::parse("\"minus\" = \"\\u-001\";", parser).has_value()
+        && not PureBundle::parse("\"prefix\" = \"\\u0x1f\";", parser).has_value());
+
+    PureBindings bindings;
+    bindings.assignVariable("name", "Anna");
+
+    const PureFormula *formula = (bundle.has_value() ? bundle->findFormula("smile") : nullptr);
+    const std::string output = (formula && rejected ? parser.execute(*formula, bindings, true) : std::string());
+    const std::string reference = "Anna \xF0\x9F\x98\x80\xC3\xA9";
+
+    return example_meta_t {
+        .formula = (formula ? formula->source : std::string()),
+        .variables = std::map<std::string, std::string>{ {"name", "Anna"} },
+        .aliases = std::set<std::string>(),
+        .reference = reference,
+        .output = output
+    };
+}
+
+static example_meta_t test_JsonBindings() {
+    PureParser parser;
+    parser.assignVariable("date", "10/10/19");
+
+    // Escaped strings get decoded, booleans switch aliases, and null discards the variable
+    const std::string json = R"( {"number": 7, "date": "11\/11\/19", "name": null, "vip": true, "note": "\"\u00e9\ud83d\ude00\""} )";
+    const bool assigned = parser.assignJson(json) && not parser.assignJson(R"({"nested": {"a": 1}})")
+        && not parser.assignJson(R"(["unnamed", 1])") && not parser.assignJson(R"({"number": 1-+e.})");
+
+    const std::string formula = "$[:vip: Dear guest, ## ]$[$name has ## You have] $[$number coupon(s) ## no coupons] expiring on $date $note";
+    const std::string output = (assigned ? parser.execute(formula, true, true) : std::string());
+    const std::string reference = "Dear guest, You have 7 coupon(s) expiring on 11/11/19 \"é😀\"";
+
+    return example_meta_t {
+        .formula = formula,
+        .variables = std::map<std::string, std::string>{ {"number", "7"}, {"date", "11/11/19"}, {"note", "\"é😀\""} },
+        .aliases = std::set<std::string>{ "vip" },
+        .reference = reference,
+        .output = output
+    };
+}
+
+static example_meta_t test_JsonLongEscapes() {
+    PureParser parser;
+
+    // Every escape is decoded, while the closing quote is still searched only once
+    std::string escaped_value;
+    for (size_t index = 0; index < 200000; index++) {
+        escaped_value += (index % 2 ? "\\\"" : "\\n");
+    }
+
+    const std::string json = R"({"number": -1.5e+3, "body": ")" + escaped_value + R"("})";
+    const bool assigned = parser.assignJson(json);
+
+    const std::string formula = "$number: $body";
+    const std::string output = (assigned ? parser.execute(formula, false, true) : std::string());
+
+    std::string body;
+    for (size_t index = 0; index < 200000; index++) {
+        body += (index % 2 ? '"' : '\n');
+    }
+
+    // The long output is compared here, and only reported briefly
+    const std::string reference = "-1.5e+3: 200000 symbols decoded";
+    return example_meta_t {
+        .formula = formula,
+        .variables = std::map<std::string, std::string>{ {"number", "-1.5e+3"}, {"body", "(200000 escaped symbols)"} },
+        .aliases = std::set<std::string>(),
+        .reference = reference,
+        .output = (output == "-1.5e+3: " + body ? reference : output.substr(0, 64))
+    };
+}
+
+static example_meta_t test_JsonSurrogates() {
+    PureParser parser;
+
+    // Only the proper pair is joined, while unpaired surrogates are replaced, keeping the output valid UTF-8
+    const std::string json = R"({"pair": "\ud83d\ude00", "mismatched": "\ud83d\u0041", "lone": "\ud83dZZZZ", "low": "\ude00!"})";
+    const bool assigned = parser.assignJson(json) && not parser.assignJson(R"({"broken": "\ud83"})");
+
+    const std::string formula = "$pair $mismatched $lone $low";
+    const std::string output = (assigned ? parser.execute(formula, true, true) : std::string());
+    const std::string reference = "\xF0\x9F\x98\x80 \xEF\xBF\xBD" "A \xEF\xBF\xBDZZZZ \xEF\xBF\xBD!";
+
+    return example_meta_t {
+        .formula = formula,
+        .variables = std::map<std::string, std::string>{ {"pair", "\xF0\x9F\x98\x80"}, {"mismatched", "\xEF\xBF\xBD" "A"}, {"lone", "\xEF\xBF\xBDZZZZ"}, {"low", "\xEF\xBF\xBD!"} },
+        .aliases = std::set<std::string>(),
+        .reference = reference,
+        .output = output
+    };
+}
+
+static example_meta_t test_BorrowedValues() {
+    PureParser parser;
+    const std::string formula = "Message: $[$body ## (empty)] from $sender";
+
+    // The long value is not copied, and is dropped by the reset after execute
+    const std::string body(4096, 'x');
+    parser.assignVariableView("body", body);
+    parser.assignVariable("sender", "Anna");
+    const bool borrowed = (parser.execute(formula, true, true) == "Message: " + body + " from Anna");
+
+    const std::string json = R"({"sender": "Bob", "body": "Hello"})";
+    parser.assignJsonView(json);
+    const std::string output = (borrowed ? parser.execute(formula, true, true) : std::string());
+    const std::string reference = "Message: Hello from Bob";
+
+    return example_meta_t {
+        .formula = formula,
+        .variables = std::map<std::string, std::string>{ {"sender", "Bob"}, {"body", "Hello"} },
+        .aliases = std::set<std::string>(),
+        .reference = reference,
+        .output = output
+    };
+}
+
+static example_meta_t test_ViewNames() {
+    PureParser parser;
+    const std::string formula = "$[:vip: Dear $name, ## Hi,] you have $number coupon(s)";
+
+    // Names are sliced from the single buffer, without constructing strings for lookups
+    const std::string_view names = "namenumbervipother";
+    parser.assignVariable(names.substr(0, 4), "Anna");
+    parser.assignVariable(names.substr(4, 6), "7");
+    parser.enableAlias(names.substr(10, 3));
+    parser.enableAlias(names.substr(13, 5));
+    parser.disableAlias(names.substr(13, 5));
+
+    const std::string output = parser.execute(formula, true, true);
+    const std::string reference = "Dear Anna, you have 7 coupon(s)";
+
+    return example_meta_t {
+        .formula = formula,
+        .variables = std::map<std::string, std::string>{ {"name", "Anna"}, {"number", "7"} },
+        .aliases = std::set<std::string>{ "vip" },
+        .reference = reference,
+        .output = output
+    };
+}
+
+static example_meta_t test_ResetKeepsEntries() {
+    PureBindings bindings;
+    const PureParser parser;
+    const PureFormula formula = parser.compile("$[:vip: Dear $name, ## Hi,] $[$number coupon(s) ## no coupons] $[until $date]");
+
+    // Nothing assigned before the reset is visible after it, though the entries are reused
+    bindings.assignVariable("name", "Anna");
+    bindings.assignVariable("date", "10/10/19");
+    bindings.enableAlias("vip");
+    bindings.reset();
+
+    bindings.assignVariable("number", "7");
+    bindings.assignVariable("date", "11/11/19");
+    bindings.enableAlias("guest");
+    bindings.disableAlias("guest");
+
+    // Too many names make the reset free the entries at last
+    for (size_t index = 0; index < 2000; index++) {
+        bindings.assignVariable("unused" + std::to_string(index), "value");
+    }
+
+    const std::string first_output = parser.execute(formula, bindings, true);
+    bindings.reset();
+    bindings.assignVariable("number", "7");
+    bindings.assignVariable("date", "11/11/19");
+
+    const std::string output = parser.execute(formula, bindings, true);
+    const std::string reference = "Hi, 7 coupon(s) until 11/11/19";
+
+    return example_meta_t {
+        .formula = formula.source,
+        .variables = std::map<std::string, std::string>{ {"number", "7"}, {"date", "11/11/19"} },
+        .aliases = std::set<std::string>(),
+        .reference = reference,
+        .output = (first_output == reference ? output : first_output)
+    };
+}
+
+static example_meta_t test_LayeredScopes() {
+    const PureParser parser;
+    const PureFormula formula = parser.compile("$[:vip: Dear $name, ## Hi,] $product by $company: $[$number coupon(s) ## no coupons]");
+
+    // Every layer is filled once, and only the request one changes per message
+    PureBindings global_scope;
+    global_scope.assignVariable("product", "Jivo");
+    global_scope.assignVariable("company", "Global Inc.");
+
+    PureBindings tenant_scope(&global_scope);
+    tenant_scope.assignVariable("company", "JivoSite");
+    tenant_scope.enableAlias("vip");
+
+    PureBindings request_scope(&tenant_scope);
+    request_scope.assignVariable("name", "Anna");
+    request_scope.assignVariable("number", "7");
+    const std::string first_output = parser.execute(formula, request_scope, true);
+
+    request_scope.reset();
+    request_scope.assignVariable("name", "Bob");
+    const std::string output = parser.execute(formula, request_scope, true);
+    const std::string reference = "Dear Bob, Jivo by JivoSite: no coupons";
+
+    return example_meta_t {
+        .formula = formula.source,
+        .variables = std::map<std::string, std::string>{ {"name", "Bob"}, {"product", "Jivo"}, {"company", "JivoSite"} },
+        .aliases = std::set<std::string>{ "vip" },
+        .reference = reference,
+        .output = (first_output == "Dear Anna, Jivo by JivoSite: 7 coupon(s)" ? output : first_output)
+    };
+}
+
+static example_meta_t test_LayeredMasking() {
+    const PureParser parser;
+    const PureFormula formula = parser.compile("$[:vip: Dear $name, ## Hi,] $product$[ by $company]");
+
+    PureBindings tenant_scope;
+    tenant_scope.assignVariable("name", "Anna");
+    tenant_scope.assignVariable("product", "Jivo");
+    tenant_scope.assignVariable("company", "JivoSite");
+    tenant_scope.enableAlias("vip");
+
+    // Discarded variables and disabled aliases hide the parent ones, until reset
+    PureBindings request_scope(&tenant_scope);
+    const bool masked = request_scope.assignJson(R"({"vip": false, "company": null})");
+    const std::string output = (masked ? parser.execute(formula, request_scope, true) : std::string());
+
+    request_scope.reset();
+    const bool uncovered = (parser.execute(formula, request_scope, true) == "Dear Anna, Jivo by JivoSite");
+    const std::string reference = "Hi, Jivo";
+
+    return example_meta_t {
+        .formula = formula.source,
+        .variables = std::map<std::string, std::string>{ {"name", "Anna"}, {"product", "Jivo"} },
+        .aliases = std::set<std::string>(),
+        .reference = reference,
+        .output = (uncovered ? output : std::string("The reset did not uncover the parent"))
+    };
+}
+
+static example_meta_t test_SharedSnapshots() {
+    const PureParser parser;
+    const PureFormula formula = parser.compile("$name, try $product$[:promo: with $discount off]");
+    PureSharedBindings shared;
+    shared.update([](PureBindings &bindings) {
+        bindings.assignVariable("product", "Jivo");
+        bindings.assignVariable("discount", "10%");
+    });
+
+    std::string first_output;
+    {
+        // The pinned snapshot keeps its values while the promo gets published
+        const PureSharedBindings::Reader reader = shared.read();
+        PureBindings request_scope(&reader);
+        request_scope.assignVariable("name", "Anna");
+
+        shared.enableAlias("promo");
+        first_output = parser.execute(formula, request_scope, true);
+    }
+
+    // Nobody reads the replaced snapshots anymore, so the next update frees them
+    shared.assignVariable("discount", "20%");
+    const bool reclaimed = (shared.retiredNumber() == 0);
+
+    const PureSharedBindings::Reader reader = shared.read();
+    PureBindings request_scope(&reader);
+    request_scope.assignVariable("name", "Bob");
+    const std::string output = parser.execute(formula, request_scope, true);
+    const std::string reference = "Bob, try Jivo with 20% off";
+
+    return example_meta_t {
+        .formula = formula.source,
+        .variables = std::map<std::string, std::string>{ {"name", "Bob"}, {"product", "Jivo"}, {"discount", "20%"} },
+        .aliases = std::set<std::string>{ "promo" },
+        .reference = reference,
+        .output = (first_output == "Anna, try Jivo" && reclaimed ? output : first_output)
+    };
+}
+
+static example_meta_t test_SharedTable() {
+    const PureParser parser;
+    const PureFormula formula = parser.compile("$name, try $product$[:promo: with $discount off]");
+    const std::string path = "/tmp/PureSharedTableExample";
+
+    // The publisher and the worker would be different processes;
+    // the odd capacity gets rounded up, so the second half is aligned too
+    std::optional<PureSharedTable> publisher = PureSharedTable::create(path, 4001);
+    std::optional<PureSharedTable> worker = PureSharedTable::open(path);
+    std::remove(path.c_str());
+    if (not publisher.has_value() || not worker.has_value()) {
+        return example_meta_t {
+            .formula = formula.source,
+            .variables = std::map<std::string, std::string>(),
+            .aliases = std::set<std::string>(),
+            .reference = std::string(),
+            .output = "Cannot map the table"
+        };
+    }
+
+    publisher->assignVariable("product", "Jivo");
+    publisher->assignVariable("discount", "10%");
+    publisher->enableAlias("promo");
+    publisher->publish();
+
+    // The reader outlived two publications, so its values could be overwritten
+    const PureSharedTable::Reader stale_reader = worker->read();
+    publisher->assignVariable("discount", "15%");
+    publisher->publish();
+    publisher->assignVariable("discount", "20%");
+    publisher->publish();
+    const bool rejected = (not stale_reader.isConsistent() && not worker->assignVariable("discount", "0%") && not worker->publish());
+
+    std::string output;
+    for (;;) {
+        const PureSharedTable::Reader reader = worker->read();
+        PureBindings request_scope(&reader);
+        request_scope.assignVariable("name", "Bob");
+        output = parser.execute(formula, request_scope, true);
+
+        if (reader.isConsistent()) {
+            break;
+        }
+    }
+
+    const std::string reference = "Bob, try Jivo with 20% off";
+    return example_meta_t {
+        .formula = formula.source,
+        .variables = std::map<std::string, std::string>{ {"name", "Bob"}, {"product", "Jivo"}, {"discount", "20%"} },
+        .aliases = std::set<std::string>{ "promo" },
+        .reference = reference,
+        .output = (rejected && worker->publishedNumber() == 3 ? output : std::string("The stale reader was not noticed"))
+    };
+}
+
+static example_meta_t test_BundleReload() {
+    const PureParser parser;
+    const std::string path = "/tmp/PureBundleManagerExample.strings";
+    const auto write_bundle = [&](const std::string &contents) {
+        std::ofstream(path, std::ios::out | std::ios::trunc) << contents;
+    };
+
+    write_bundle("\"greeting\" = \"Hello, $name\";");
+    PureBundleManager manager(parser);
+    const bool added = manager.add("en", path);
+
+    PureBindings bindings;
+    bindings.assignVariable("name", "Anna");
+
+    std::string first_output;
+    {
+        // The render in progress keeps the bundle it has started with
+        const PureBundleManager::Reader reader = manager.read();
+        write_bundle("\"greeting\" = \"Hi, $name\";");
+        manager.reload("en");
+
+        const PureFormula *formula = reader.findFormula("en", "greeting");
+        first_output = (formula ? parser.execute(*formula, bindings, true) : std::string());
+    }
+
+    // The broken file keeps the previous bundle
+    write_bundle("\"greeting\" = ");
+    const bool rejected = (not manager.reload("en") && manager.failuresNumber() == 1);
+    std::remove(path.c_str());
+
+    const PureBundleManager::Reader reader = manager.read();
+    const PureFormula *formula = reader.findFormula("en", "greeting");
+    const std::string output = (formula ? parser.execute(*formula, bindings, true) : std::string());
+    const std::string reference = "Hi, Anna";
+
+    return example_meta_t {
+        .formula = (formula ? formula->source : std::string()),
+        .variables = std::map<std::string, std::string>{ {"name", "Anna"} },
+        .aliases = std::set<std::string>(),
+        .reference = reference,
+        .output = (added && rejected && first_output == "Hello, Anna" ? output : first_output)
+    };
+}
+
 #pragma mark - Execute all examples
 
 #ifndef main_cpp
@@ -210,7 +881,29 @@ int main_cpp() {
         declare_example_case(test_InactiveBlock),
         declare_example_case(test_ComplexActiveAlias),
         declare_example_case(test_ComplexInactiveAlias),
-        declare_example_case(test_Coupons)
+        declare_example_case(test_Coupons),
+        declare_example_case(test_SessionRefresh),
+        declare_example_case(test_StreamedFormula),
+        declare_example_case(test_ChunkedOutput),
+        declare_example_case(test_VectoredOutput),
+        declare_example_case(test_RuntimeStatistics),
+        declare_example_case(test_FormulaProfile),
+        declare_example_case(test_ProfileEviction),
+        declare_example_case(test_TracePoints),
+        declare_example_case(test_SharedFormulaBindings),
+        declare_example_case(test_BundleFormulas),
+        declare_example_case(test_BundleEscapes),
+        declare_example_case(test_JsonBindings),
+        declare_example_case(test_JsonSurrogates),
+        declare_example_case(test_JsonLongEscapes),
+        declare_example_case(test_BorrowedValues),
+        declare_example_case(test_ViewNames),
+        declare_example_case(test_ResetKeepsEntries),
+        declare_example_case(test_LayeredScopes),
+        declare_example_case(test_LayeredMasking),
+        declare_example_case(test_SharedSnapshots),
+        declare_example_case(test_SharedTable),
+        declare_example_case(test_BundleReload)
     };
     #undef declare_example_case
 
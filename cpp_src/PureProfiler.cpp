@@ -0,0 +1,226 @@
+//
+//  PureProfiler.cpp
+//  PureParser
+//
+//  Copyright © 2019 JivoSite Inc. All rights reserved.
+//  <For detailed info about how this parser works, please refer to README.md file>
+//
+
+#include "PureProfiler.hpp"
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <mutex>
+#include <unordered_map>
+
+/**
+ * All the profiles, along with the slow log settings
+ */
+struct PureProfilerRegistry {
+    std::mutex mutex;
+    std::unordered_multimap<size_t, PureFormulaProfile> profiles;
+    size_t capacity = kPureProfilerDefaultCapacity;
+    uint64_t slow_threshold_ns = 0;
+    PureProfiler::SlowLogger slow_logger;
+};
+
+static PureProfilerRegistry &shared_registry();
+static PureFormulaProfile &obtain_profile(PureProfilerRegistry &registry, size_t hash, std::string_view formula);
+static void evict_rare_profile(PureProfilerRegistry &registry);
+static void log_slow_execution(const PureSlowExecution &execution);
+
+static thread_local std::vector<std::string> current_rejected_frames;
+
+std::atomic<bool> PureProfiler::_enabled(false);
+
+double PureFormulaProfile::p99() const {
+    if (latency.count == 0) {
+        return 0;
+    }
+
+    // Find the bucket with the percentile,
+    // and assume the values are spread evenly within it
+    const uint64_t rank = uint64_t(std::ceil(latency.count * 0.99));
+    uint64_t cumulative_count = 0;
+    for (size_t bucket = 0; bucket < kPureHistogramBucketsNumber; bucket++) {
+        const uint64_t bucket_count = latency.buckets[bucket];
+        if (cumulative_count + bucket_count < rank) {
+            cumulative_count += bucket_count;
+            continue;
+        }
+
+        const double lower_bound = (bucket > 0 ? PureHistogramValues::upperBound(bucket - 1) : 0);
+        const double upper_bound = PureHistogramValues::upperBound(bucket);
+        if (std::isinf(upper_bound)) {
+            return lower_bound;
+        }
+
+        return lower_bound + (upper_bound - lower_bound) * double(rank - cumulative_count) / bucket_count;
+    }
+
+    return 0;
+}
+
+double PureFormulaProfile::averageOutput() const {
+    return (calls > 0 ? double(output_bytes) / calls : 0);
+}
+
+std::vector<std::pair<std::string, uint64_t>> PureFormulaProfile::mostRejectedFrames(size_t limit) const {
+    std::vector<std::pair<std::string, uint64_t>> frames(rejected_frames.begin(), rejected_frames.end());
+    std::stable_sort(frames.begin(), frames.end(), [](const auto &first, const auto &second) {
+        return first.second > second.second;
+    });
+
+    if (frames.size() > limit) {
+        frames.resize(limit);
+    }
+
+    return frames;
+}
+
+void PureProfiler::setEnabled(bool enabled) {
+    _enabled.store(enabled, std::memory_order_relaxed);
+}
+
+void PureProfiler::setSlowThreshold(uint64_t threshold_ns, SlowLogger logger) {
+    PureProfilerRegistry &registry = shared_registry();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    registry.slow_threshold_ns = threshold_ns;
+    registry.slow_logger = (logger ? logger : log_slow_execution);
+}
+
+void PureProfiler::setCapacity(size_t capacity) {
+    PureProfilerRegistry &registry = shared_registry();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    registry.capacity = std::max<size_t>(capacity, 1);
+    while (registry.profiles.size() > registry.capacity) {
+        evict_rare_profile(registry);
+    }
+}
+
+std::vector<PureFormulaProfile> PureProfiler::snapshot() {
+    std::vector<PureFormulaProfile> profiles;
+    {
+        PureProfilerRegistry &registry = shared_registry();
+        std::lock_guard<std::mutex> lock(registry.mutex);
+        for (const auto &profile : registry.profiles) {
+            profiles.push_back(profile.second);
+        }
+    }
+
+    std::sort(profiles.begin(), profiles.end(), [](const PureFormulaProfile &first, const PureFormulaProfile &second) {
+        return first.total_ns > second.total_ns;
+    });
+
+    return profiles;
+}
+
+void PureProfiler::reset() {
+    PureProfilerRegistry &registry = shared_registry();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    registry.profiles.clear();
+}
+
+void PureProfiler::beginExecution() {
+    current_rejected_frames.clear();
+}
+
+void PureProfiler::recordRejectedFrame(std::string description) {
+    current_rejected_frames.push_back(std::move(description));
+}
+
+void PureProfiler::recordExecution(std::string_view formula, uint64_t elapsed_ns, size_t output_len) {
+    const size_t hash = std::hash<std::string_view>()(formula);
+    uint64_t slow_threshold_ns = 0;
+    SlowLogger slow_logger;
+
+    {
+        PureProfilerRegistry &registry = shared_registry();
+        std::lock_guard<std::mutex> lock(registry.mutex);
+
+        PureFormulaProfile &profile = obtain_profile(registry, hash, formula);
+        profile.calls++;
+        profile.total_ns += elapsed_ns;
+        profile.output_bytes += output_len;
+        profile.latency.buckets[PureHistogramValues::bucketIndex(elapsed_ns)]++;
+        profile.latency.count++;
+        profile.latency.sum_ns += elapsed_ns;
+
+        for (const auto &frame : current_rejected_frames) {
+            profile.rejected_frames[frame]++;
+        }
+
+        if (registry.slow_threshold_ns > 0 && elapsed_ns >= registry.slow_threshold_ns) {
+            slow_threshold_ns = registry.slow_threshold_ns;
+            slow_logger = registry.slow_logger;
+        }
+    }
+
+    // Report out of the lock, since the logger may take a while
+    if (slow_threshold_ns > 0) {
+        slow_logger(PureSlowExecution {
+            .hash = hash,
+            .formula = formula,
+            .elapsed_ns = elapsed_ns,
+            .output_len = output_len,
+            .rejected_frames = current_rejected_frames
+        });
+    }
+
+    current_rejected_frames.clear();
+}
+
+static PureProfilerRegistry &shared_registry() {
+    // Never destroyed, since threads may finish after the static destructors
+    static PureProfilerRegistry * const registry = new PureProfilerRegistry();
+    return *registry;
+}
+
+static PureFormulaProfile &obtain_profile(PureProfilerRegistry &registry, size_t hash, std::string_view formula) {
+    // Different formulas may share the hash, so compare the text as well
+    const auto range = registry.profiles.equal_range(hash);
+    for (auto iter = range.first; iter != range.second; iter++) {
+        if (iter->second.formula == formula) {
+            return iter->second;
+        }
+    }
+
+    if (registry.profiles.size() >= registry.capacity) {
+        evict_rare_profile(registry);
+    }
+
+    PureFormulaProfile profile;
+    profile.hash = hash;
+    profile.formula = std::string(formula);
+    return registry.profiles.emplace(hash, std::move(profile))->second;
+}
+
+static void evict_rare_profile(PureProfilerRegistry &registry) {
+    const auto rare_iter = std::min_element(registry.profiles.begin(), registry.profiles.end(), [](const auto &first, const auto &second) {
+        return first.second.calls < second.second.calls;
+    });
+
+    if (rare_iter != registry.profiles.end()) {
+        registry.profiles.erase(rare_iter);
+    }
+}
+
+static void log_slow_execution(const PureSlowExecution &execution) {
+    // Keep the line readable for the long formulas,
+    // cutting them not in the middle of UTF-8 sequence
+    const size_t max_formula_len = 120;
+    std::string_view formula = execution.formula;
+    if (formula.size() > max_formula_len) {
+        size_t formula_len = max_formula_len;
+        while (formula_len > 0 && (static_cast<unsigned char>(formula[formula_len]) & 0xC0) == 0x80) {
+            formula_len--;
+        }
+
+        formula = formula.substr(0, formula_len);
+    }
+
+    std::cerr << "[PureParser] Slow formula #" << execution.hash
+        << " took " << execution.elapsed_ns << "ns, output " << execution.output_len << " bytes"
+        << ", rejected " << execution.rejected_frames.size() << " frames: \"" << formula
+        << (formula.size() < execution.formula.size() ? "...\" (" + std::to_string(execution.formula.size()) + " bytes)" : "\"") << std::endl;
+}
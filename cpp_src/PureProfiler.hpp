@@ -0,0 +1,126 @@
+//
+//  PureProfiler.hpp
+//  PureParser
+//
+//  Copyright © 2019 JivoSite Inc. All rights reserved.
+//  <For detailed info about how this parser works, please refer to README.md file>
+//
+
+#ifndef PureProfiler_hpp
+#define PureProfiler_hpp
+
+#include "PureStatistics.hpp"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+/**
+ * How many formulas get profiled at most by default
+ */
+const size_t kPureProfilerDefaultCapacity = 1024;
+
+/**
+ * What is known about executing a formula
+ */
+struct PureFormulaProfile {
+    size_t hash = 0;
+    std::string formula;
+    uint64_t calls = 0;
+    uint64_t total_ns = 0;
+    uint64_t output_bytes = 0;
+    PureHistogramValues latency;
+
+    /// How many times every frame was rejected,
+    /// frames are described by their alias and variables
+    std::map<std::string, uint64_t> rejected_frames;
+
+    /**
+     * Estimated 99th percentile of execution time, in nanoseconds
+     */
+    double p99() const;
+
+    /**
+     * Average output size, in bytes
+     */
+    double averageOutput() const;
+
+    /**
+     * The frames rejected most often, the most rejected first
+     */
+    std::vector<std::pair<std::string, uint64_t>> mostRejectedFrames(size_t limit) const;
+};
+
+/**
+ * The execution being slower than the threshold
+ */
+struct PureSlowExecution {
+    size_t hash;
+    std::string_view formula;
+    uint64_t elapsed_ns;
+    size_t output_len;
+    const std::vector<std::string> &rejected_frames;
+};
+
+/**
+ * The process-wide per-formula profiler;
+ * formulas are distinguished by their text, so even ones with the same hash never get merged
+ */
+class PureProfiler {
+public:
+    typedef std::function<void(const PureSlowExecution &execution)> SlowLogger;
+
+    /**
+     * Start or stop profiling; disabled by default
+     */
+    static void setEnabled(bool enabled);
+    static bool isEnabled() { return _enabled.load(std::memory_order_relaxed); }
+
+    /**
+     * Report every execution taking `threshold_ns` or longer into `logger`,
+     * or into `stderr` if no logger passed; zero threshold stops reporting
+     */
+    static void setSlowThreshold(uint64_t threshold_ns, SlowLogger logger = nullptr);
+
+    /**
+     * Limit the number of formulas being profiled;
+     * when a new formula comes into the full table, the profile with the fewest calls gets evicted,
+     * so the frequent formulas stay while the rare ones replace each other
+     */
+    static void setCapacity(size_t capacity);
+
+    /**
+     * Get the profiles collected so far, the most expensive (by total time) first
+     */
+    static std::vector<PureFormulaProfile> snapshot();
+
+    /**
+     * Forget the profiles collected so far
+     */
+    static void reset();
+
+    /**
+     * Start a new execution on the current thread
+     */
+    static void beginExecution();
+
+    /**
+     * Remember the frame rejected within the current execution
+     */
+    static void recordRejectedFrame(std::string description);
+
+    /**
+     * Account the execution finished on the current thread
+     */
+    static void recordExecution(std::string_view formula, uint64_t elapsed_ns, size_t output_len);
+
+private:
+    static std::atomic<bool> _enabled;
+};
+
+#endif /* PureProfiler_hpp */
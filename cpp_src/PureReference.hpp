@@ -0,0 +1,79 @@
+//
+//  PureReference.hpp
+//  PureParser
+//
+//  Copyright © 2019 JivoSite Inc. All rights reserved.
+//  <For detailed info about how this parser works, please refer to README.md file>
+//
+
+#ifndef PureReference_hpp
+#define PureReference_hpp
+
+#include "PureParser.hpp"
+#include "PureElement.hpp"
+#include <string>
+#include <map>
+#include <set>
+#include <optional>
+
+/**
+ * The reference parser,
+ * the original recursive implementation kept as is, including its edge cases;
+ * every other way of executing formulas has to produce exactly the same output.
+ * Please do not optimize it: it exists to be compared against
+ */
+class PureReferenceParser {
+public:
+    /**
+     * Create the parser with the custom configuration,
+     * or use the built-in one with standard tokens
+     */
+    PureReferenceParser(PureConfig config = {});
+
+    /**
+     * Reset all variables and aliases being assigned between executes
+     */
+    void reset();
+
+    /**
+     * Variables management:
+     * - assign the value to variable
+     * - discard the variable
+     */
+    void assignVariable(std::string name, std::string value);
+    void discardVariable(std::string name);
+
+    /**
+     * Alias management:
+     * - enable the alias
+     * - discard the alias
+     */
+    void enableAlias(std::string name);
+    void disableAlias(std::string name);
+
+    /**
+     * Execute the formula with previously assigned variables and aliases
+     */
+    std::string execute(std::string formula, bool collapse_spaces, bool reset_on_finish);
+
+private:
+    std::optional<PureElement> recognizeFrame(std::string input, size_t *scanned_len);
+    std::optional<PureElement> recognizeElement(std::string input, size_t *scanned_len);
+    std::optional<PureElement> recognizeBlockElement(std::string input, size_t *scanned_len);
+    std::optional<PureElement> recognizeVariableElement(std::string input, size_t *scanned_len);
+
+    std::optional<std::string> resolveFrame(const PureElement &frame);
+    std::optional<std::string> resolveSlice(const PureElement &slice);
+    std::optional<std::string> resolveElement(const PureElement &element);
+    std::optional<std::string> resolveBlockElement(const PureElement &block);
+    std::optional<std::string> resolveVariableElement(const PureElement &variable);
+
+    std::string removeExtraSpaces(std::string string);
+
+private:
+    PureConfig _config;
+    std::map<std::string, std::string> _assigned_variables;
+    std::set<std::string> _enabled_aliases;
+};
+
+#endif /* PureReference_hpp */
@@ -31,7 +31,7 @@ bool PureScanner::canContinue() const {
 
 bool PureScanner::detectAndSlice(std::string needle) {
     const size_t offset = _current_iter - input.begin();
-    if (input.find(needle, offset) == offset) {
+    if (input.compare(offset, needle.length(), needle) == 0) {
         // If `needle` exists at current pointer location,
         // then replace this scanner with a new one
         
@@ -64,7 +64,7 @@ bool PureScanner::detectAndExtract(std::string opener_token, std::string closer_
     // There are some descriptive steps inside
 	for (size_t index = since_index, len = input.length(); index < len; index++) {
         // The `closer_token` found
-		if (input.find(closer_token, index) == index) {
+		if (input.compare(index, closer_token.length(), closer_token) == 0) {
             // (0) Found the `closer_token` being at root level;
             // this is not the correct behaviour, so abandon this operation
 			if (depth == 0) {
@@ -87,7 +87,7 @@ bool PureScanner::detectAndExtract(std::string opener_token, std::string closer_
 			}
 		}
         // The `opener_token` found
-		else if (input.find(opener_token, index) == index) {
+		else if (input.compare(index, opener_token.length(), opener_token) == 0) {
             // (1) Found the `opener_token` being at root level;
             // so, remember the opening position
 			if (depth == 0) {
@@ -0,0 +1,36 @@
+//
+//  PureScope.hpp
+//  PureParser
+//
+//  Copyright © 2019 JivoSite Inc. All rights reserved.
+//  <For detailed info about how this parser works, please refer to README.md file>
+//
+
+#ifndef PureScope_hpp
+#define PureScope_hpp
+
+#include <string_view>
+#include <optional>
+
+/**
+ * Anything that formulas can be executed with:
+ * it knows the values of variables and which aliases are enabled;
+ * scopes can be stacked, so that the request scope overlays the tenant one,
+ * which overlays the global one, and lookups fall through them without copying
+ */
+class PureScope {
+public:
+    virtual ~PureScope() = default;
+
+    /**
+     * Get the value of variable, or `std::nullopt` if it is not assigned
+     */
+    virtual std::optional<std::string_view> findVariable(std::string_view name) const = 0;
+
+    /**
+     * Whether the alias is enabled
+     */
+    virtual bool isAliasEnabled(std::string_view name) const = 0;
+};
+
+#endif /* PureScope_hpp */
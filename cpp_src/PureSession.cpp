@@ -0,0 +1,262 @@
+//
+//  PureSession.cpp
+//  PureParser
+//
+//  Copyright © 2019 JivoSite Inc. All rights reserved.
+//  <For detailed info about how this parser works, please refer to README.md file>
+//
+
+#include "PureSession.hpp"
+#include "PureStatistics.hpp"
+#include <algorithm>
+
+static void collect_dependencies(const PureElement &element, std::set<std::string, std::less<>> *variables, std::set<std::string, std::less<>> *aliases);
+static bool intersects(const std::set<std::string, std::less<>> &first, const std::set<std::string, std::less<>> &second);
+
+PureSession::PureSession(PureConfig config)
+: _parser(config) {
+    this->_next_output_id = 0;
+}
+
+size_t PureSession::attach(std::string formula, bool collapse_spaces) {
+    const size_t output_id = _next_output_id++;
+    Entry &entry = _entries.emplace(output_id, Entry {
+        .formula = _parser.compile(formula),
+        .collapse_spaces = collapse_spaces,
+        .segments = {},
+        .output = std::string()
+    }).first->second;
+
+    // The root frame alias affects the whole output
+    const std::string &root_alias = entry.formula.root.payload;
+    if (not root_alias.empty()) {
+        _alias_dependents[root_alias].insert(output_id);
+    }
+
+    // Split the root frame into segments,
+    // and remember what every segment depends on
+    for (const auto &element : entry.formula.root.children) {
+        Segment segment {
+            .element = &element,
+            .variables = {},
+            .aliases = {},
+            .output = std::nullopt
+        };
+        collect_dependencies(element, &segment.variables, &segment.aliases);
+        renderSegment(segment);
+
+        for (const auto &variable : segment.variables) {
+            _variable_dependents[variable].insert(output_id);
+        }
+
+        for (const auto &alias : segment.aliases) {
+            _alias_dependents[alias].insert(output_id);
+        }
+
+        entry.segments.push_back(segment);
+    }
+
+    composeEntry(entry);
+    return output_id;
+}
+
+void PureSession::detach(size_t output_id) {
+    _entries.erase(output_id);
+
+    // Forget the output within dependency indexes,
+    // so that further changes would not look for it
+    for (auto &dependents : _variable_dependents) {
+        dependents.second.erase(output_id);
+    }
+
+    for (auto &dependents : _alias_dependents) {
+        dependents.second.erase(output_id);
+    }
+}
+
+void PureSession::assignVariable(std::string_view name, std::string_view value) {
+    // Assigning the same value changes nothing
+    if (_parser._bindings.assignVariable(name, value)) {
+        _changed_variables.emplace(name);
+    }
+}
+
+void PureSession::discardVariable(std::string_view name) {
+    if (_parser._bindings.discardVariable(name)) {
+        _changed_variables.emplace(name);
+    }
+}
+
+void PureSession::enableAlias(std::string_view name) {
+    if (_parser._bindings.enableAlias(name)) {
+        _changed_aliases.emplace(name);
+    }
+}
+
+void PureSession::disableAlias(std::string_view name) {
+    if (_parser._bindings.disableAlias(name)) {
+        _changed_aliases.emplace(name);
+    }
+}
+
+std::vector<size_t> PureSession::refresh() {
+    // Find all outputs depending on anything changed
+    std::set<size_t> affected_ids;
+    for (const auto &variable : _changed_variables) {
+        const auto dependents_iter = _variable_dependents.find(variable);
+        if (dependents_iter != _variable_dependents.end()) {
+            affected_ids.insert(dependents_iter->second.begin(), dependents_iter->second.end());
+        }
+    }
+
+    for (const auto &alias : _changed_aliases) {
+        const auto dependents_iter = _alias_dependents.find(alias);
+        if (dependents_iter != _alias_dependents.end()) {
+            affected_ids.insert(dependents_iter->second.begin(), dependents_iter->second.end());
+        }
+    }
+
+    // Within every affected output, re-render only the affected segments,
+    // and then compose the output again from cached segments
+    std::vector<size_t> changed_ids;
+    for (const size_t output_id : affected_ids) {
+        Entry &entry = _entries.at(output_id);
+        size_t rendered_number = 0;
+        for (auto &segment : entry.segments) {
+            if (intersects(segment.variables, _changed_variables) || intersects(segment.aliases, _changed_aliases)) {
+                renderSegment(segment);
+                rendered_number++;
+            }
+        }
+
+        if (PureStatistics::isEnabled()) {
+            PureStatistics::count(PureCounterCacheMisses, rendered_number);
+            PureStatistics::count(PureCounterCacheHits, entry.segments.size() - rendered_number);
+        }
+
+        if (composeEntry(entry)) {
+            changed_ids.push_back(output_id);
+        }
+    }
+
+    _changed_variables.clear();
+    _changed_aliases.clear();
+    return changed_ids;
+}
+
+const std::string &PureSession::output(size_t output_id) const {
+    return _entries.at(output_id).output;
+}
+
+void PureSession::renderSegment(Segment &segment) {
+    // The unassigned variable, or the inactive frame, makes the segment invalid;
+    // blocks are always valid, even if they produce nothing
+    const PureElement &element = *segment.element;
+    const PureScope &scope = _parser._bindings;
+    const bool valid = (element.type == PureElementTypeVariable
+        ? scope.findVariable(element.payload).has_value()
+        : element.type != PureElementTypeFrame || _parser.isFrameActive(element, scope));
+
+    if (not valid) {
+        segment.output = std::nullopt;
+        return;
+    }
+
+    // Write the segment the same way the root frame writes its elements, keeping the capacity
+    std::string &output = (segment.output.has_value() ? *segment.output : segment.output.emplace());
+    output.clear();
+    PureStringOutput string_output(output);
+    switch (element.type) {
+        case PureElementTypeFrame:
+            _parser.writeFrame(element, scope, string_output);
+            break;
+
+        case PureElementTypeBlock:
+            _parser.writeBlockElement(element, scope, string_output);
+            break;
+
+        case PureElementTypeVariable:
+            string_output.write(*scope.findVariable(element.payload));
+            break;
+
+        case PureElementTypeSlice:
+            string_output.write(element.payload);
+            break;
+    }
+
+    string_output.finish();
+}
+
+bool PureSession::composeEntry(Entry &entry) {
+    std::string output;
+    PureStringOutput string_output(output);
+
+    // Whether we should remove all extra spaces on the fly
+    if (entry.collapse_spaces) {
+        PureCollapsingOutput collapsing_output(string_output);
+        writeSegments(entry, collapsing_output);
+    }
+    else {
+        writeSegments(entry, string_output);
+    }
+
+    if (output == entry.output) {
+        return false;
+    }
+    else {
+        entry.output = output;
+        return true;
+    }
+}
+
+void PureSession::writeSegments(const Entry &entry, PureOutput &output) const {
+    // Compose the output the same way the root frame gets written:
+    // inactive alias, or any invalid segment, makes the entire output empty
+    const std::string &root_alias = entry.formula.root.payload;
+    const bool root_active = (root_alias.empty() || _parser._bindings.isAliasEnabled(root_alias));
+    const bool segments_valid = std::all_of(entry.segments.begin(), entry.segments.end(), [](const Segment &segment) {
+        return segment.output.has_value();
+    });
+
+    if (root_active && segments_valid) {
+        for (const auto &segment : entry.segments) {
+            output.write(*segment.output);
+        }
+    }
+
+    output.finish();
+}
+
+static void collect_dependencies(const PureElement &element, std::set<std::string, std::less<>> *variables, std::set<std::string, std::less<>> *aliases) {
+    // Frames depend on their aliases,
+    // and variables depend on themselves
+    if (element.type == PureElementTypeFrame && not element.payload.empty()) {
+        aliases->insert(element.payload);
+    }
+    else if (element.type == PureElementTypeVariable) {
+        variables->insert(element.payload);
+    }
+
+    for (const auto &child : element.children) {
+        collect_dependencies(child, variables, aliases);
+    }
+}
+
+static bool intersects(const std::set<std::string, std::less<>> &first, const std::set<std::string, std::less<>> &second) {
+    // Both sets are ordered, so walk them together
+    auto first_iter = first.begin();
+    auto second_iter = second.begin();
+    while (first_iter != first.end() && second_iter != second.end()) {
+        if (*first_iter < *second_iter) {
+            first_iter++;
+        }
+        else if (*second_iter < *first_iter) {
+            second_iter++;
+        }
+        else {
+            return true;
+        }
+    }
+
+    return false;
+}
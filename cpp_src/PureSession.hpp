@@ -0,0 +1,105 @@
+//
+//  PureSession.hpp
+//  PureParser
+//
+//  Copyright © 2019 JivoSite Inc. All rights reserved.
+//  <For detailed info about how this parser works, please refer to README.md file>
+//
+
+#ifndef PureSession_hpp
+#define PureSession_hpp
+
+#include "PureParser.hpp"
+#include "PureFormula.hpp"
+#include <string>
+#include <string_view>
+#include <vector>
+#include <map>
+#include <set>
+#include <optional>
+#include <functional>
+
+/**
+ * The rendering session,
+ * keeps many formulas rendered at once and tracks which variables and aliases they depend on;
+ * so that changing a variable re-renders only the outputs and segments affected by it
+ */
+class PureSession {
+public:
+    /**
+     * Create the session with the custom configuration,
+     * or use the built-in one with standard tokens
+     */
+    PureSession(PureConfig config = {});
+
+    /**
+     * Outputs management:
+     * - compile and render the formula, then keep it up to date; returns the output identifier
+     * - stop tracking the output
+     */
+    size_t attach(std::string formula, bool collapse_spaces);
+    void detach(size_t output_id);
+
+    /**
+     * Variables management:
+     * - assign the value to variable
+     * - discard the variable
+     */
+    void assignVariable(std::string_view name, std::string_view value);
+    void discardVariable(std::string_view name);
+
+    /**
+     * Alias management:
+     * - enable the alias
+     * - discard the alias
+     */
+    void enableAlias(std::string_view name);
+    void disableAlias(std::string_view name);
+
+    /**
+     * Re-render the outputs affected by variables and aliases changed since the last refresh
+     * @return identifiers of outputs whose contents have actually changed
+     */
+    std::vector<size_t> refresh();
+
+    /**
+     * The most recently rendered output
+     * @param output_id identifier returned by `attach`
+     */
+    const std::string &output(size_t output_id) const;
+
+private:
+    /// Names looked up by views without constructing strings
+    typedef std::set<std::string, std::less<>> Names;
+
+    /// A top-level element of the formula with its own cached output
+    struct Segment {
+        const PureElement *element;
+        Names variables;
+        Names aliases;
+        std::optional<std::string> output;
+    };
+
+    /// A tracked formula along with its segments
+    struct Entry {
+        PureFormula formula;
+        bool collapse_spaces;
+        std::vector<Segment> segments;
+        std::string output;
+    };
+
+    void renderSegment(Segment &segment);
+    bool composeEntry(Entry &entry);
+    void writeSegments(const Entry &entry, PureOutput &output) const;
+
+private:
+    PureParser _parser;
+    size_t _next_output_id;
+    std::map<size_t, Entry> _entries;
+    std::map<std::string, std::set<size_t>, std::less<>> _variable_dependents;
+    std::map<std::string, std::set<size_t>, std::less<>> _alias_dependents;
+    Names _changed_variables;
+    Names _changed_aliases;
+};
+
+#endif /* PureSession_hpp */
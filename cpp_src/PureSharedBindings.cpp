@@ -0,0 +1,67 @@
+//
+//  PureSharedBindings.cpp
+//  PureParser
+//
+//  Copyright © 2019 JivoSite Inc. All rights reserved.
+//  <For detailed info about how this parser works, please refer to README.md file>
+//
+
+#include "PureSharedBindings.hpp"
+
+PureSharedBindings::Reader::Reader(const PureSharedBindings &shared)
+: _pin()
+, _snapshot(shared._current.load()) {
+}
+
+PureSharedBindings::Reader::~Reader() = default;
+
+std::optional<std::string_view> PureSharedBindings::Reader::findVariable(std::string_view name) const {
+    return _snapshot->findVariable(name);
+}
+
+bool PureSharedBindings::Reader::isAliasEnabled(std::string_view name) const {
+    return _snapshot->isAliasEnabled(name);
+}
+
+PureSharedBindings::PureSharedBindings()
+: _current(new PureBindings()) {
+}
+
+PureSharedBindings::~PureSharedBindings() {
+    // Nobody may read while destroying, and the collector destroys the replaced snapshots
+    delete _current.load();
+}
+
+PureSharedBindings::Reader PureSharedBindings::read() const {
+    return Reader(*this);
+}
+
+void PureSharedBindings::update(const std::function<void(PureBindings &bindings)> &changes) {
+    std::lock_guard<std::mutex> lock(_writer_mutex);
+
+    PureBindings *snapshot = new PureBindings(*_current.load());
+    changes(*snapshot);
+
+    _collector.retire(_current.exchange(snapshot));
+}
+
+void PureSharedBindings::assignVariable(std::string_view name, std::string_view value) {
+    update([&](PureBindings &bindings) { bindings.assignVariable(name, value); });
+}
+
+void PureSharedBindings::discardVariable(std::string_view name) {
+    update([&](PureBindings &bindings) { bindings.discardVariable(name); });
+}
+
+void PureSharedBindings::enableAlias(std::string_view name) {
+    update([&](PureBindings &bindings) { bindings.enableAlias(name); });
+}
+
+void PureSharedBindings::disableAlias(std::string_view name) {
+    update([&](PureBindings &bindings) { bindings.disableAlias(name); });
+}
+
+size_t PureSharedBindings::retiredNumber() const {
+    std::lock_guard<std::mutex> lock(_writer_mutex);
+    return _collector.retiredNumber();
+}
@@ -0,0 +1,90 @@
+//
+//  PureSharedBindings.hpp
+//  PureParser
+//
+//  Copyright © 2019 JivoSite Inc. All rights reserved.
+//  <For detailed info about how this parser works, please refer to README.md file>
+//
+
+#ifndef PureSharedBindings_hpp
+#define PureSharedBindings_hpp
+
+#include "PureScope.hpp"
+#include "PureBindings.hpp"
+#include "PureEpoch.hpp"
+#include <string>
+#include <string_view>
+#include <atomic>
+#include <mutex>
+#include <functional>
+#include <cstdint>
+
+/**
+ * The bindings shared by the whole process, e.g. the product name or the current promo,
+ * being updated rarely by some thread, and read by every rendering thread:
+ * - readers never lock, they just pin the current snapshot for a while
+ * - every update copies the snapshot, changes the copy, and publishes it at once
+ * - replaced snapshots are freed only when no reader could still see them
+ */
+class PureSharedBindings {
+public:
+    /**
+     * The pinned snapshot, to be used as the scope of executing,
+     * or as the parent of per-request `PureBindings`;
+     * it sees the same values until destroyed, regardless of updates,
+     * so keep it only while executing, otherwise the replaced snapshots cannot be freed
+     */
+    class Reader: public PureScope {
+    public:
+        explicit Reader(const PureSharedBindings &shared);
+        ~Reader() override;
+
+        Reader(const Reader&) = delete;
+        Reader &operator=(const Reader&) = delete;
+
+        std::optional<std::string_view> findVariable(std::string_view name) const override;
+        bool isAliasEnabled(std::string_view name) const override;
+
+    private:
+        PureEpochPin _pin;
+        const PureBindings *_snapshot;
+    };
+
+    PureSharedBindings();
+    ~PureSharedBindings();
+
+    PureSharedBindings(const PureSharedBindings&) = delete;
+    PureSharedBindings &operator=(const PureSharedBindings&) = delete;
+
+    /**
+     * Pin the current snapshot for reading
+     */
+    Reader read() const;
+
+    /**
+     * Apply many changes to the copy of current snapshot, and publish them at once;
+     * values must be owned, not assigned as views, since the snapshot outlives the update;
+     * updates are serialized, and never block readers
+     */
+    void update(const std::function<void(PureBindings &bindings)> &changes);
+
+    /**
+     * Single changes, each published separately
+     */
+    void assignVariable(std::string_view name, std::string_view value);
+    void discardVariable(std::string_view name);
+    void enableAlias(std::string_view name);
+    void disableAlias(std::string_view name);
+
+    /**
+     * The number of replaced snapshots still waiting for readers to leave them
+     */
+    size_t retiredNumber() const;
+
+private:
+    std::atomic<const PureBindings*> _current;
+    mutable std::mutex _writer_mutex;
+    PureEpochCollector _collector;
+};
+
+#endif /* PureSharedBindings_hpp */
@@ -0,0 +1,348 @@
+//
+//  PureSharedTable.cpp
+//  PureParser
+//
+//  Copyright © 2019 JivoSite Inc. All rights reserved.
+//  <For detailed info about how this parser works, please refer to README.md file>
+//
+
+#include "PureSharedTable.hpp"
+#include <atomic>
+#include <cstring>
+#include <new>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+/**
+ * The file starts with the header, followed by two halves of `half_size` bytes;
+ * publication number N writes the half N % 2, moving the sequence from 2N-2 to odd 2N-1 while writing, and then to 2N
+ */
+struct PureSharedTableHeader {
+    uint32_t magic;
+    uint32_t version;
+    uint64_t half_size;
+    std::atomic<uint64_t> sequence;
+};
+
+/**
+ * The half starts with the numbers, followed by the index of variables sorted by name,
+ * the index of aliases sorted by name, and then the names and values themselves
+ */
+struct PureSharedTableHalf {
+    uint32_t variables_number;
+    uint32_t aliases_number;
+};
+
+/// Offsets are counted from the half start
+struct PureSharedTableEntry {
+    uint32_t name_offset;
+    uint32_t name_length;
+    uint32_t value_offset;
+    uint32_t value_length;
+};
+
+static_assert(std::atomic<uint64_t>::is_always_lock_free, "The sequence must work across processes");
+
+static const uint32_t kPureSharedTableMagic = 0x50555254;
+static const uint32_t kPureSharedTableVersion = 1;
+
+static PureSharedTableHeader *header_of(char *mapping) {
+    return reinterpret_cast<PureSharedTableHeader *>(mapping);
+}
+
+static size_t half_offset(uint64_t sequence, uint64_t half_size) {
+    return sizeof(PureSharedTableHeader) + ((sequence / 2) % 2) * half_size;
+}
+
+#pragma mark - Reader
+
+PureSharedTable::Reader::Reader(const PureSharedTable &table)
+: _table(&table) {
+    const PureSharedTableHeader *header = header_of(table._mapping);
+    this->_sequence = header->sequence.load(std::memory_order_acquire);
+    this->_half = table._mapping + half_offset(_sequence, header->half_size);
+}
+
+std::optional<std::string_view> PureSharedTable::Reader::findVariable(std::string_view name) const {
+    PureSharedTableHalf numbers;
+    std::memcpy(&numbers, _half, sizeof(numbers));
+    return findEntry(0, numbers.variables_number, name);
+}
+
+bool PureSharedTable::Reader::isAliasEnabled(std::string_view name) const {
+    PureSharedTableHalf numbers;
+    std::memcpy(&numbers, _half, sizeof(numbers));
+    return findEntry(numbers.variables_number, numbers.aliases_number, name).has_value();
+}
+
+bool PureSharedTable::Reader::isConsistent() const {
+    // The half being read gets overwritten starting with the second publication after the one read
+    std::atomic_thread_fence(std::memory_order_acquire);
+    const uint64_t sequence = header_of(_table->_mapping)->sequence.load(std::memory_order_relaxed);
+    return sequence < (_sequence & ~uint64_t(1)) + 3;
+}
+
+std::optional<std::string_view> PureSharedTable::Reader::findEntry(size_t first_index, size_t entries_number, std::string_view name) const {
+    // The half may be overwritten while reading, so nothing is trusted to stay within it;
+    // the file may come from elsewhere with any half size, so the entries are copied instead of cast
+    const uint64_t half_size = header_of(_table->_mapping)->half_size;
+    const char *entries = _half + sizeof(PureSharedTableHalf);
+    if (sizeof(PureSharedTableHalf) + (uint64_t(first_index) + entries_number) * sizeof(PureSharedTableEntry) > half_size) {
+        return std::nullopt;
+    }
+
+    const auto string_at = [&](uint32_t offset, uint32_t length) {
+        if (uint64_t(offset) + length > half_size) {
+            return std::string_view();
+        }
+
+        return std::string_view(_half + offset, length);
+    };
+
+    size_t lower = first_index;
+    size_t upper = first_index + entries_number;
+    while (lower < upper) {
+        const size_t middle = lower + (upper - lower) / 2;
+        PureSharedTableEntry entry;
+        std::memcpy(&entry, entries + middle * sizeof(PureSharedTableEntry), sizeof(entry));
+        const int comparison = string_at(entry.name_offset, entry.name_length).compare(name);
+        if (comparison == 0) {
+            return string_at(entry.value_offset, entry.value_length);
+        }
+        else if (comparison < 0) {
+            lower = middle + 1;
+        }
+        else {
+            upper = middle;
+        }
+    }
+
+    return std::nullopt;
+}
+
+#pragma mark - Table
+
+std::optional<PureSharedTable> PureSharedTable::create(const std::string &path, size_t capacity) {
+    // Keep the second half aligned as the first one
+    const size_t alignment = alignof(PureSharedTableEntry);
+    capacity = (capacity + alignment - 1) / alignment * alignment;
+    if (capacity < sizeof(PureSharedTableHalf) || capacity > UINT32_MAX) {
+        return std::nullopt;
+    }
+
+    // The readers of replaced file keep their mapping of it
+    unlink(path.c_str());
+    const int fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_EXCL, 0644);
+    if (fd < 0) {
+        return std::nullopt;
+    }
+
+    const size_t mapping_size = sizeof(PureSharedTableHeader) + 2 * capacity;
+    void *mapping = MAP_FAILED;
+    if (ftruncate(fd, mapping_size) == 0) {
+        mapping = mmap(nullptr, mapping_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    }
+
+    close(fd);
+    if (mapping == MAP_FAILED) {
+        unlink(path.c_str());
+        return std::nullopt;
+    }
+
+    // Both halves are zeros so far, which is the empty table
+    PureSharedTableHeader *header = new (mapping) PureSharedTableHeader;
+    header->version = kPureSharedTableVersion;
+    header->half_size = capacity;
+    header->sequence.store(0, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    header->magic = kPureSharedTableMagic;
+
+    return PureSharedTable(static_cast<char *>(mapping), mapping_size, true);
+}
+
+std::optional<PureSharedTable> PureSharedTable::open(const std::string &path) {
+    const int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return std::nullopt;
+    }
+
+    struct stat file_stat;
+    void *mapping = MAP_FAILED;
+    if (fstat(fd, &file_stat) == 0 && size_t(file_stat.st_size) >= sizeof(PureSharedTableHeader)) {
+        mapping = mmap(nullptr, file_stat.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    }
+
+    close(fd);
+    if (mapping == MAP_FAILED) {
+        return std::nullopt;
+    }
+
+    PureSharedTable table(static_cast<char *>(mapping), file_stat.st_size, false);
+    const PureSharedTableHeader *header = header_of(table._mapping);
+    if (header->magic != kPureSharedTableMagic || header->version != kPureSharedTableVersion) {
+        return std::nullopt;
+    }
+
+    if (header->half_size < sizeof(PureSharedTableHalf) || sizeof(PureSharedTableHeader) + 2 * header->half_size > table._mapping_size) {
+        return std::nullopt;
+    }
+
+    return table;
+}
+
+PureSharedTable::PureSharedTable(char *mapping, size_t mapping_size, bool writable)
+: _mapping(mapping)
+, _mapping_size(mapping_size)
+, _writable(writable) {
+}
+
+PureSharedTable::PureSharedTable(PureSharedTable &&other)
+: _mapping(other._mapping)
+, _mapping_size(other._mapping_size)
+, _writable(other._writable)
+, _pending_variables(std::move(other._pending_variables))
+, _pending_aliases(std::move(other._pending_aliases)) {
+    other._mapping = nullptr;
+}
+
+PureSharedTable &PureSharedTable::operator=(PureSharedTable &&other) {
+    if (this != &other) {
+        if (_mapping) {
+            munmap(_mapping, _mapping_size);
+        }
+
+        _mapping = other._mapping;
+        _mapping_size = other._mapping_size;
+        _writable = other._writable;
+        _pending_variables = std::move(other._pending_variables);
+        _pending_aliases = std::move(other._pending_aliases);
+        other._mapping = nullptr;
+    }
+
+    return *this;
+}
+
+PureSharedTable::~PureSharedTable() {
+    if (_mapping) {
+        munmap(_mapping, _mapping_size);
+    }
+}
+
+PureSharedTable::Reader PureSharedTable::read() const {
+    return Reader(*this);
+}
+
+bool PureSharedTable::assignVariable(std::string_view name, std::string_view value) {
+    if (not _writable) {
+        return false;
+    }
+
+    const auto variable_iter = _pending_variables.find(name);
+    if (variable_iter == _pending_variables.end()) {
+        _pending_variables.emplace(name, value);
+    }
+    else {
+        variable_iter->second.assign(value);
+    }
+
+    return true;
+}
+
+bool PureSharedTable::discardVariable(std::string_view name) {
+    if (not _writable) {
+        return false;
+    }
+
+    const auto variable_iter = _pending_variables.find(name);
+    if (variable_iter != _pending_variables.end()) {
+        _pending_variables.erase(variable_iter);
+    }
+
+    return true;
+}
+
+bool PureSharedTable::enableAlias(std::string_view name) {
+    if (not _writable) {
+        return false;
+    }
+
+    if (_pending_aliases.find(name) == _pending_aliases.end()) {
+        _pending_aliases.emplace(name);
+    }
+
+    return true;
+}
+
+bool PureSharedTable::disableAlias(std::string_view name) {
+    if (not _writable) {
+        return false;
+    }
+
+    const auto alias_iter = _pending_aliases.find(name);
+    if (alias_iter != _pending_aliases.end()) {
+        _pending_aliases.erase(alias_iter);
+    }
+
+    return true;
+}
+
+bool PureSharedTable::publish() {
+    if (not _writable) {
+        return false;
+    }
+
+    PureSharedTableHeader *header = header_of(_mapping);
+    const uint64_t entries_number = _pending_variables.size() + _pending_aliases.size();
+    uint64_t required_size = sizeof(PureSharedTableHalf) + entries_number * sizeof(PureSharedTableEntry);
+    for (const auto &variable : _pending_variables) {
+        required_size += variable.first.size() + variable.second.size();
+    }
+    for (const auto &alias : _pending_aliases) {
+        required_size += alias.size();
+    }
+
+    if (required_size > header->half_size) {
+        return false;
+    }
+
+    // Mark the writing first, so the readers of the half being overwritten know they are late
+    const uint64_t sequence = header->sequence.load(std::memory_order_relaxed);
+    header->sequence.store(sequence + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    char *half = _mapping + half_offset(sequence + 2, header->half_size);
+    const PureSharedTableHalf numbers { uint32_t(_pending_variables.size()), uint32_t(_pending_aliases.size()) };
+    std::memcpy(half, &numbers, sizeof(numbers));
+
+    // The maps are sorted already, so the readers can search by halving
+    size_t entry_offset = sizeof(PureSharedTableHalf);
+    size_t string_offset = entry_offset + entries_number * sizeof(PureSharedTableEntry);
+    const auto write_entry = [&](std::string_view name, std::string_view value) {
+        const PureSharedTableEntry entry {
+            uint32_t(string_offset), uint32_t(name.size()),
+            uint32_t(string_offset + name.size()), uint32_t(value.size())
+        };
+
+        std::memcpy(half + entry_offset, &entry, sizeof(entry));
+        std::memcpy(half + string_offset, name.data(), name.size());
+        std::memcpy(half + string_offset + name.size(), value.data(), value.size());
+        entry_offset += sizeof(entry);
+        string_offset += name.size() + value.size();
+    };
+
+    for (const auto &variable : _pending_variables) {
+        write_entry(variable.first, variable.second);
+    }
+    for (const auto &alias : _pending_aliases) {
+        write_entry(alias, std::string_view());
+    }
+
+    header->sequence.store(sequence + 2, std::memory_order_release);
+    return true;
+}
+
+uint64_t PureSharedTable::publishedNumber() const {
+    return header_of(_mapping)->sequence.load(std::memory_order_acquire) / 2;
+}
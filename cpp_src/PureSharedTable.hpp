@@ -0,0 +1,110 @@
+//
+//  PureSharedTable.hpp
+//  PureParser
+//
+//  Copyright © 2019 JivoSite Inc. All rights reserved.
+//  <For detailed info about how this parser works, please refer to README.md file>
+//
+
+#ifndef PureSharedTable_hpp
+#define PureSharedTable_hpp
+
+#include "PureScope.hpp"
+#include <string>
+#include <string_view>
+#include <map>
+#include <set>
+#include <optional>
+#include <cstdint>
+
+/**
+ * The table of variables and aliases living in the memory-mapped file,
+ * written by single publisher process, and read by many worker processes without copying;
+ * on Linux, the file under `/dev/shm` is the POSIX shared memory segment.
+ *
+ * The file keeps two halves, and every publication writes the half not being read,
+ * guarded by the sequence lock: readers never wait, but check afterwards
+ * whether the publisher could have overwritten what they were reading
+ */
+class PureSharedTable {
+public:
+    /**
+     * The table as it was published when the reader was created, to be used as the scope of executing;
+     * the values point right into the shared memory, so once done with them,
+     * make sure the reader `isConsistent()`, or retry with the new one otherwise
+     */
+    class Reader: public PureScope {
+    public:
+        explicit Reader(const PureSharedTable &table);
+
+        std::optional<std::string_view> findVariable(std::string_view name) const override;
+        bool isAliasEnabled(std::string_view name) const override;
+
+        /**
+         * Whether nothing read so far could be overwritten by the publisher
+         */
+        bool isConsistent() const;
+
+    private:
+        std::optional<std::string_view> findEntry(size_t first_index, size_t entries_number, std::string_view name) const;
+
+    private:
+        const PureSharedTable *_table;
+        uint64_t _sequence;
+        const char *_half;
+    };
+
+    /**
+     * Create the file at `path` for publishing, each half taking `capacity` bytes (rounded up to keep the index aligned)
+     * for names, values, and their index, or open the existing file for reading;
+     * creating replaces the file, so the readers having the old one opened keep its last publication until reopening;
+     * @return `std::nullopt` if the file cannot be created, mapped, or is not the table
+     */
+    static std::optional<PureSharedTable> create(const std::string &path, size_t capacity);
+    static std::optional<PureSharedTable> open(const std::string &path);
+
+    PureSharedTable(PureSharedTable &&other);
+    PureSharedTable &operator=(PureSharedTable &&other);
+    ~PureSharedTable();
+
+    PureSharedTable(const PureSharedTable&) = delete;
+    PureSharedTable &operator=(const PureSharedTable&) = delete;
+
+    /**
+     * Read the last published table
+     */
+    Reader read() const;
+
+    /**
+     * Publisher side: change the pending variables and aliases, to be published at once;
+     * @return `false` if opened for reading, changing nothing
+     */
+    bool assignVariable(std::string_view name, std::string_view value);
+    bool discardVariable(std::string_view name);
+    bool enableAlias(std::string_view name);
+    bool disableAlias(std::string_view name);
+
+    /**
+     * Publisher side: publish the pending variables and aliases;
+     * @return `false` if opened for reading, or the table exceeds the capacity
+     */
+    bool publish();
+
+    /**
+     * The number of publications so far
+     */
+    uint64_t publishedNumber() const;
+
+private:
+    PureSharedTable(char *mapping, size_t mapping_size, bool writable);
+
+private:
+    char *_mapping;
+    size_t _mapping_size;
+    bool _writable;
+
+    std::map<std::string, std::string, std::less<>> _pending_variables;
+    std::set<std::string, std::less<>> _pending_aliases;
+};
+
+#endif /* PureSharedTable_hpp */
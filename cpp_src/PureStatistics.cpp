@@ -0,0 +1,335 @@
+//
+//  PureStatistics.cpp
+//  PureParser
+//
+//  Copyright © 2019 JivoSite Inc. All rights reserved.
+//  <For detailed info about how this parser works, please refer to README.md file>
+//
+
+#include "PureStatistics.hpp"
+#include "PureProfiler.hpp"
+#include <limits>
+#include <mutex>
+#include <set>
+#include <sstream>
+
+typedef std::chrono::steady_clock statistics_clock_t;
+
+static const char * const counter_names[PureCountersNumber] = {
+    "executes", "compiles", "output_bytes", "blocks", "frames_tried", "frames_accepted", "cache_hits", "cache_misses"
+};
+
+static const char * const counter_helps[PureCountersNumber] = {
+    "Formulas executed",
+    "Formulas compiled separately from executing",
+    "Bytes of output produced",
+    "Blocks resolved",
+    "Frames checked within blocks",
+    "Frames chosen within blocks",
+    "Session segments reused from cache",
+    "Session segments rendered again"
+};
+
+static const char * const histogram_names[PureHistogramsNumber] = {
+    "execute", "recognize", "resolve", "collapse"
+};
+
+static const char * const histogram_helps[PureHistogramsNumber] = {
+    "Time of the entire execute or compile",
+    "Time of recognizing the formula",
+    "Time of resolving the output",
+    "Time of collapsing the spaces"
+};
+
+/**
+ * The statistics of a single thread;
+ * only the owner thread writes here, so the relaxed atomics are enough
+ * to let the snapshot read the values at any moment
+ */
+struct PureStatisticsShard {
+    std::atomic<uint64_t> counters[PureCountersNumber] = {};
+    std::atomic<uint64_t> buckets[PureHistogramsNumber][kPureHistogramBucketsNumber] = {};
+    std::atomic<uint64_t> sums[PureHistogramsNumber] = {};
+};
+
+/**
+ * All the shards being alive,
+ * along with the values of shards whose threads have finished
+ */
+struct PureStatisticsRegistry {
+    std::mutex mutex;
+    std::set<const PureStatisticsShard*> shards;
+    PureStatisticsSnapshot finished;
+    PureStatisticsSnapshot baseline;
+};
+
+static PureStatisticsRegistry &shared_registry();
+static void add_relaxed(std::atomic<uint64_t> &target, uint64_t value);
+static void append_shard(PureStatisticsSnapshot &snapshot, const PureStatisticsShard &shard);
+
+/**
+ * Registers the shard of current thread on first use,
+ * and keeps its values after the thread is finished
+ */
+class PureStatisticsShardHolder {
+public:
+    PureStatisticsShardHolder() {
+        PureStatisticsRegistry &registry = shared_registry();
+        std::lock_guard<std::mutex> lock(registry.mutex);
+        registry.shards.insert(&shard);
+    }
+
+    ~PureStatisticsShardHolder() {
+        PureStatisticsRegistry &registry = shared_registry();
+        std::lock_guard<std::mutex> lock(registry.mutex);
+        registry.shards.erase(&shard);
+        append_shard(registry.finished, shard);
+    }
+
+    PureStatisticsShard shard;
+};
+
+static thread_local PureStatisticsShardHolder current_shard_holder;
+static thread_local size_t current_scopes_depth = 0;
+static thread_local size_t current_output_len = 0;
+
+std::atomic<bool> PureStatistics::_enabled(false);
+
+double PureHistogramValues::upperBound(size_t bucket) {
+    if (bucket + 1 < kPureHistogramBucketsNumber) {
+        return double(uint64_t(1) << (bucket + 7));
+    }
+    else {
+        return std::numeric_limits<double>::infinity();
+    }
+}
+
+size_t PureHistogramValues::bucketIndex(uint64_t value_ns) {
+    size_t bucket = 0;
+    while (bucket + 1 < kPureHistogramBucketsNumber && value_ns > (uint64_t(1) << (bucket + 7))) {
+        bucket++;
+    }
+
+    return bucket;
+}
+
+void PureStatistics::setEnabled(bool enabled) {
+    _enabled.store(enabled, std::memory_order_relaxed);
+}
+
+PureStatisticsSnapshot PureStatistics::snapshot() {
+    PureStatisticsRegistry &registry = shared_registry();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+
+    PureStatisticsSnapshot snapshot = registry.finished;
+    for (const PureStatisticsShard *shard : registry.shards) {
+        append_shard(snapshot, *shard);
+    }
+
+    // The values before the last reset are not shown
+    for (size_t counter = 0; counter < PureCountersNumber; counter++) {
+        snapshot.counters[counter] -= registry.baseline.counters[counter];
+    }
+
+    for (size_t histogram = 0; histogram < PureHistogramsNumber; histogram++) {
+        PureHistogramValues &values = snapshot.histograms[histogram];
+        const PureHistogramValues &baseline_values = registry.baseline.histograms[histogram];
+        for (size_t bucket = 0; bucket < kPureHistogramBucketsNumber; bucket++) {
+            values.buckets[bucket] -= baseline_values.buckets[bucket];
+        }
+
+        values.count -= baseline_values.count;
+        values.sum_ns -= baseline_values.sum_ns;
+    }
+
+    return snapshot;
+}
+
+void PureStatistics::reset() {
+    // Shards cannot be zeroed from other threads,
+    // so remember the current values to subtract them later
+    PureStatisticsRegistry &registry = shared_registry();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+
+    registry.baseline = registry.finished;
+    for (const PureStatisticsShard *shard : registry.shards) {
+        append_shard(registry.baseline, *shard);
+    }
+}
+
+void PureStatistics::count(PureCounter counter, uint64_t value) {
+    add_relaxed(current_shard_holder.shard.counters[counter], value);
+}
+
+void PureStatistics::observe(PureHistogram histogram, uint64_t value_ns) {
+    PureStatisticsShard &shard = current_shard_holder.shard;
+    add_relaxed(shard.buckets[histogram][PureHistogramValues::bucketIndex(value_ns)], 1);
+    add_relaxed(shard.sums[histogram], value_ns);
+}
+
+PureStatisticsScope::PureStatisticsScope(PureCounter counter, std::string_view formula) {
+    this->_counter = counter;
+    this->_collecting = PureStatistics::isEnabled();
+    this->_profiling = (PureProfiler::isEnabled() && counter == PureCounterExecutes);
+    this->_counted = (_collecting || _profiling);
+    this->_outermost = (_counted && current_scopes_depth++ == 0);
+
+    if (_outermost) {
+        current_output_len = 0;
+        _started_at = statistics_clock_t::now();
+        for (size_t phase = 0; phase < PurePhasesNumber; phase++) {
+            _phases_elapsed_ns[phase] = PureAccountant::elapsedTime(PurePhase(phase));
+        }
+
+        // The text is kept, since the formula may be gone by the end of scope
+        if (_profiling) {
+            _formula = formula;
+            PureProfiler::beginExecution();
+        }
+    }
+}
+
+PureStatisticsScope::~PureStatisticsScope() {
+    if (_counted) {
+        current_scopes_depth--;
+    }
+
+    if (not _outermost) {
+        return;
+    }
+
+    const auto elapsed = statistics_clock_t::now() - _started_at;
+    const uint64_t elapsed_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count();
+
+    if (_profiling) {
+        PureProfiler::recordExecution(_formula, elapsed_ns, current_output_len);
+    }
+
+    if (not _collecting) {
+        return;
+    }
+
+    PureStatistics::observe(PureHistogramExecute, elapsed_ns);
+    PureStatistics::count(_counter, 1);
+    PureStatistics::count(PureCounterOutputBytes, current_output_len);
+
+    // Only the phases actually passed are observed,
+    // e.g. executing the compiled formula does not recognize anything
+    const std::pair<PurePhase, PureHistogram> phase_histograms[] = {
+        {PurePhaseRecognize, PureHistogramRecognize},
+        {PurePhaseResolve, PureHistogramResolve},
+        {PurePhaseCollapse, PureHistogramCollapse}
+    };
+
+    for (const auto &phase_histogram : phase_histograms) {
+        const double phase_elapsed_ns = PureAccountant::elapsedTime(phase_histogram.first) - _phases_elapsed_ns[phase_histogram.first];
+        if (phase_elapsed_ns > 0) {
+            PureStatistics::observe(phase_histogram.second, uint64_t(phase_elapsed_ns));
+        }
+    }
+}
+
+void PureStatisticsScope::addOutputBytes(size_t bytes) {
+    // Nested scopes account the bytes for the outermost one
+    if (_counted) {
+        current_output_len += bytes;
+    }
+}
+
+std::string PureStatisticsSnapshot::toPrometheus() const {
+    std::ostringstream stream;
+
+    for (size_t counter = 0; counter < PureCountersNumber; counter++) {
+        const std::string name = std::string("pure_parser_") + counter_names[counter] + "_total";
+        stream << "# HELP " << name << " " << counter_helps[counter] << "\n";
+        stream << "# TYPE " << name << " counter\n";
+        stream << name << " " << counters[counter] << "\n";
+    }
+
+    for (size_t histogram = 0; histogram < PureHistogramsNumber; histogram++) {
+        const std::string name = std::string("pure_parser_") + histogram_names[histogram] + "_seconds";
+        const PureHistogramValues &values = histograms[histogram];
+        stream << "# HELP " << name << " " << histogram_helps[histogram] << "\n";
+        stream << "# TYPE " << name << " histogram\n";
+
+        // Prometheus buckets are cumulative
+        uint64_t cumulative_count = 0;
+        for (size_t bucket = 0; bucket < kPureHistogramBucketsNumber; bucket++) {
+            cumulative_count += values.buckets[bucket];
+            stream << name << "_bucket{le=\"";
+            if (bucket + 1 < kPureHistogramBucketsNumber) {
+                stream << PureHistogramValues::upperBound(bucket) / 1e9;
+            }
+            else {
+                stream << "+Inf";
+            }
+            stream << "\"} " << cumulative_count << "\n";
+        }
+
+        stream << name << "_sum " << values.sum_ns / 1e9 << "\n";
+        stream << name << "_count " << values.count << "\n";
+    }
+
+    return stream.str();
+}
+
+std::string PureStatisticsSnapshot::toJson() const {
+    std::ostringstream stream;
+
+    stream << "{\"counters\": {";
+    for (size_t counter = 0; counter < PureCountersNumber; counter++) {
+        stream << (counter > 0 ? ", " : "") << "\"" << counter_names[counter] << "\": " << counters[counter];
+    }
+
+    stream << "}, \"histograms\": {";
+    for (size_t histogram = 0; histogram < PureHistogramsNumber; histogram++) {
+        const PureHistogramValues &values = histograms[histogram];
+        stream << (histogram > 0 ? ", " : "") << "\"" << histogram_names[histogram] << "\": {\"count\": " << values.count
+            << ", \"sum_ns\": " << values.sum_ns << ", \"buckets\": [";
+
+        // The unbounded bucket is written with null bound
+        for (size_t bucket = 0; bucket < kPureHistogramBucketsNumber; bucket++) {
+            stream << (bucket > 0 ? ", " : "") << "{\"le_ns\": ";
+            if (bucket + 1 < kPureHistogramBucketsNumber) {
+                stream << uint64_t(PureHistogramValues::upperBound(bucket));
+            }
+            else {
+                stream << "null";
+            }
+            stream << ", \"count\": " << values.buckets[bucket] << "}";
+        }
+
+        stream << "]}";
+    }
+
+    stream << "}}";
+    return stream.str();
+}
+
+static PureStatisticsRegistry &shared_registry() {
+    // Never destroyed, since threads may finish after the static destructors
+    static PureStatisticsRegistry * const registry = new PureStatisticsRegistry();
+    return *registry;
+}
+
+static void add_relaxed(std::atomic<uint64_t> &target, uint64_t value) {
+    // The only writer is the owner thread, so no read-modify-write is needed
+    target.store(target.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+}
+
+static void append_shard(PureStatisticsSnapshot &snapshot, const PureStatisticsShard &shard) {
+    for (size_t counter = 0; counter < PureCountersNumber; counter++) {
+        snapshot.counters[counter] += shard.counters[counter].load(std::memory_order_relaxed);
+    }
+
+    for (size_t histogram = 0; histogram < PureHistogramsNumber; histogram++) {
+        PureHistogramValues &values = snapshot.histograms[histogram];
+        for (size_t bucket = 0; bucket < kPureHistogramBucketsNumber; bucket++) {
+            const uint64_t bucket_count = shard.buckets[histogram][bucket].load(std::memory_order_relaxed);
+            values.buckets[bucket] += bucket_count;
+            values.count += bucket_count;
+        }
+
+        values.sum_ns += shard.sums[histogram].load(std::memory_order_relaxed);
+    }
+}
@@ -0,0 +1,175 @@
+//
+//  PureStatistics.hpp
+//  PureParser
+//
+//  Copyright © 2019 JivoSite Inc. All rights reserved.
+//  <For detailed info about how this parser works, please refer to README.md file>
+//
+
+#ifndef PureStatistics_hpp
+#define PureStatistics_hpp
+
+#include "PureAccounting.hpp"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+/**
+ * Cumulative counters
+ */
+enum PureCounter {
+    /// Formulas executed, textual and compiled ones
+    PureCounterExecutes,
+
+    /// Formulas compiled separately from executing
+    PureCounterCompiles,
+
+    /// Bytes of output produced by executes
+    PureCounterOutputBytes,
+
+    /// Blocks resolved, and frames checked and chosen within them
+    PureCounterBlocks,
+    PureCounterFramesTried,
+    PureCounterFramesAccepted,
+
+    /// Segments of session outputs reused from cache, or rendered again
+    PureCounterCacheHits,
+    PureCounterCacheMisses,
+
+    PureCountersNumber
+};
+
+/**
+ * Latency histograms, in nanoseconds
+ */
+enum PureHistogram {
+    /// The entire execute, or compile if done separately
+    PureHistogramExecute,
+
+    /// Phases within the execute or compile,
+    /// each one not including the time of others
+    PureHistogramRecognize,
+    PureHistogramResolve,
+    PureHistogramCollapse,
+
+    PureHistogramsNumber
+};
+
+/**
+ * Histogram buckets have power-of-two upper bounds
+ * from 128ns to 2^27ns (about 134ms), and the last one is unbounded
+ */
+constexpr size_t kPureHistogramBucketsNumber = 22;
+
+/**
+ * The values of a histogram;
+ * the buckets are not cumulative
+ */
+struct PureHistogramValues {
+    uint64_t buckets[kPureHistogramBucketsNumber] = {};
+    uint64_t count = 0;
+    uint64_t sum_ns = 0;
+
+    /**
+     * Upper bound of the bucket in nanoseconds,
+     * or infinity for the last one
+     */
+    static double upperBound(size_t bucket);
+
+    /**
+     * The bucket for the value in nanoseconds
+     */
+    static size_t bucketIndex(uint64_t value_ns);
+};
+
+/**
+ * All the statistics at the moment of taking the snapshot
+ */
+struct PureStatisticsSnapshot {
+    uint64_t counters[PureCountersNumber] = {};
+    PureHistogramValues histograms[PureHistogramsNumber];
+
+    /**
+     * Dump the snapshot for exporters:
+     * in the Prometheus text exposition format, or as JSON object
+     */
+    std::string toPrometheus() const;
+    std::string toJson() const;
+};
+
+/**
+ * The process-wide runtime statistics;
+ * every thread collects them into its own shard without any locks,
+ * and the snapshot sums all the shards up
+ */
+class PureStatistics {
+public:
+    /**
+     * Start or stop collecting; disabled by default,
+     * and cost a single flag check per execute then
+     */
+    static void setEnabled(bool enabled);
+    static bool isEnabled() { return _enabled.load(std::memory_order_relaxed); }
+
+    /**
+     * Get the values collected so far, by all threads
+     */
+    static PureStatisticsSnapshot snapshot();
+
+    /**
+     * Start counting from zero
+     */
+    static void reset();
+
+    /**
+     * Add to the counter, or observe the histogram value
+     */
+    static void count(PureCounter counter, uint64_t value);
+    static void observe(PureHistogram histogram, uint64_t value_ns);
+
+private:
+    static std::atomic<bool> _enabled;
+};
+
+/**
+ * Records the execute or compile for the lifetime of the scope,
+ * along with the phases passed within, into the statistics and the profiler;
+ * nested scopes are parts of the outer ones and are not recorded separately
+ */
+class PureStatisticsScope {
+public:
+    PureStatisticsScope(PureCounter counter, std::string_view formula);
+    ~PureStatisticsScope();
+
+    PureStatisticsScope(const PureStatisticsScope &) = delete;
+    PureStatisticsScope &operator=(const PureStatisticsScope &) = delete;
+
+    /**
+     * Account the bytes produced
+     */
+    void addOutputBytes(size_t bytes);
+
+private:
+    PureCounter _counter;
+    bool _counted;
+    bool _outermost;
+    bool _collecting;
+    bool _profiling;
+    std::string _formula;
+    std::chrono::steady_clock::time_point _started_at;
+    double _phases_elapsed_ns[PurePhasesNumber];
+};
+
+/**
+ * Phases are tracked if the library is built with `PURE_PARSER_ACCOUNTING`,
+ * or while the statistics are enabled
+ */
+#ifdef PURE_PARSER_ACCOUNTING
+#define PURE_PHASE_SCOPE(phase) const PurePhaseScope pure_phase_scope(phase, true)
+#else
+#define PURE_PHASE_SCOPE(phase) const PurePhaseScope pure_phase_scope(phase, PureStatistics::isEnabled())
+#endif
+
+#endif /* PureStatistics_hpp */
@@ -0,0 +1,314 @@
+//
+//  PureStreamParser.cpp
+//  PureParser
+//
+//  Copyright © 2019 JivoSite Inc. All rights reserved.
+//  <For detailed info about how this parser works, please refer to README.md file>
+//
+
+#include "PureStreamParser.hpp"
+#include <cctype>
+#include <algorithm>
+
+static bool is_variable_symbol(char symbol);
+
+PureStreamParser::PureStreamParser(Consumer consumer, PureConfig config)
+: _parser(config), _consumer(consumer) {
+    this->_state = StateLeading;
+    this->_cursor = 0;
+    this->_slice_begin = 0;
+    this->_element_pending = false;
+    this->_element_begin = 0;
+    this->_probe = 0;
+    this->_depth = 0;
+}
+
+void PureStreamParser::feed(std::string_view chunk) {
+    // Everything after the root separator is ignored anyway
+    if (_state == StateDone) {
+        return;
+    }
+
+    _input.append(chunk.data(), chunk.size());
+    proceed(false);
+
+    // The contents before the cursor cannot become a part of any element,
+    // so pass it further as a slice right away
+    if ((_state == StateLeading || _state == StateBody) && not _element_pending) {
+        emitSlice(_cursor);
+    }
+
+    compact();
+}
+
+void PureStreamParser::finish() {
+    if (_state == StateDone) {
+        return;
+    }
+
+    proceed(true);
+
+    // Place the rest of contents as the last slice
+    if (_state != StateDone) {
+        emitSlice(_input.size());
+        _state = StateDone;
+    }
+
+    compact();
+}
+
+const std::string &PureStreamParser::alias() const {
+    return _alias;
+}
+
+size_t PureStreamParser::pendingSize() const {
+    return _input.size();
+}
+
+PureStreamParser::Match PureStreamParser::match(const std::string &token, size_t index, bool finishing) const {
+    // The token is there entirely
+    const size_t available_len = _input.size() - index;
+    if (available_len >= token.length()) {
+        return (_input.compare(index, token.length(), token) == 0) ? MatchFound : MatchNone;
+    }
+
+    // Only the beginning of the token is there,
+    // so we cannot decide until the next chunk arrives
+    if (not finishing && token.compare(0, available_len, _input, index, available_len) == 0) {
+        return MatchNeedsMore;
+    }
+    else {
+        return MatchNone;
+    }
+}
+
+void PureStreamParser::proceed(bool finishing) {
+    const PureConfig &config = _parser._config;
+
+    // The same steps as the root frame recognition does,
+    // but able to stop at any place and wait for more contents
+    while (_state != StateDone) {
+        if (_state == StateAlias) {
+            if (proceedAlias(finishing)) continue; else break;
+        }
+
+        if (_element_pending) {
+            if (proceedElement(finishing)) continue; else break;
+        }
+
+        if (_cursor >= _input.size()) {
+            break;
+        }
+
+        // (0) The alias token may appear only before any valuable symbol
+        if (_state == StateLeading) {
+            const Match alias_match = match(config.alias_token, _cursor, finishing);
+            if (alias_match == MatchNeedsMore) {
+                break;
+            }
+            else if (alias_match == MatchFound) {
+                emitSlice(_cursor);
+                _state = StateAlias;
+                _cursor += config.alias_token.length();
+                _slice_begin = _cursor;
+                _probe = _cursor;
+                continue;
+            }
+        }
+
+        // (2) The element token starts an element, to be recognized later
+        const Match element_match = match(config.element_token, _cursor, finishing);
+        if (element_match == MatchNeedsMore) {
+            break;
+        }
+        else if (element_match == MatchFound) {
+            emitSlice(_cursor);
+            _state = StateBody;
+            _cursor += config.element_token.length();
+            _element_pending = true;
+            _element_begin = _cursor;
+            _element_is_block.reset();
+            _probe = _cursor;
+            _depth = 0;
+            continue;
+        }
+
+        // (3) The separator token finishes the root frame
+        const Match separator_match = match(config.separator_token, _cursor, finishing);
+        if (separator_match == MatchNeedsMore) {
+            break;
+        }
+        else if (separator_match == MatchFound) {
+            emitSlice(_cursor);
+            _state = StateDone;
+            break;
+        }
+
+        // No especial tokens were found, so just continue looking
+        if (_state == StateLeading && not isspace(_input[_cursor])) {
+            _state = StateBody;
+        }
+
+        _cursor++;
+    }
+}
+
+bool PureStreamParser::proceedAlias(bool finishing) {
+    const std::string &alias_token = _parser._config.alias_token;
+
+    // Look for the closing alias token
+    const size_t alias_end = _input.find(alias_token, _probe);
+    if (alias_end != std::string::npos) {
+        // The empty alias name keeps the alias scanning on
+        if (alias_end == _slice_begin) {
+            _cursor = alias_end + alias_token.length();
+            _slice_begin = _cursor;
+            _probe = _cursor;
+            return true;
+        }
+
+        _alias = _input.substr(_slice_begin, alias_end - _slice_begin);
+        _state = StateBody;
+        _cursor = alias_end + alias_token.length();
+        _slice_begin = _cursor;
+        return true;
+    }
+
+    // The alias was never closed,
+    // so the rest of contents is just a slice
+    if (finishing) {
+        emitSlice(_input.size());
+        _state = StateDone;
+        return false;
+    }
+
+    // Keep the place where the token could begin to look from there next time
+    const size_t tail_len = alias_token.length() - 1;
+    _probe = std::max(_slice_begin, (_input.size() > tail_len) ? _input.size() - tail_len : 0);
+    return false;
+}
+
+bool PureStreamParser::proceedElement(bool finishing) {
+    const PureConfig &config = _parser._config;
+
+    // First, decide whether it's the block
+    if (not _element_is_block.has_value()) {
+        const Match opener_match = match(config.block_opener_token, _element_begin, finishing);
+        if (opener_match == MatchNeedsMore) {
+            return false;
+        }
+
+        _element_is_block = (opener_match == MatchFound);
+    }
+
+    bool recognized = false;
+    if (*_element_is_block) {
+        // Find the closer token at the same depth the way the scanner does
+        while (_probe < _input.size()) {
+            const Match closer_match = match(config.block_closer_token, _probe, finishing);
+            if (closer_match == MatchNeedsMore) {
+                return false;
+            }
+            else if (closer_match == MatchFound) {
+                if (_depth == 0) {
+                    break;
+                }
+                else if (--_depth == 0) {
+                    recognized = true;
+                    break;
+                }
+            }
+            else {
+                const Match opener_match = match(config.block_opener_token, _probe, finishing);
+                if (opener_match == MatchNeedsMore) {
+                    return false;
+                }
+                else if (opener_match == MatchFound) {
+                    _depth++;
+                }
+            }
+
+            _probe++;
+        }
+
+        // The block may still be closed by the following chunks
+        if (not recognized && _probe >= _input.size() && not finishing) {
+            return false;
+        }
+
+        // Recognize the entire block now, as its contents are complete
+        if (recognized) {
+            const size_t block_end = _probe + config.block_closer_token.length();
+            const std::string block_input = _input.substr(_element_begin, block_end - _element_begin);
+
+            size_t block_len = 0;
+            const std::optional<PureElement> block = _parser.recognizeBlockElement(block_input, &block_len);
+            if (block.has_value()) {
+                _consumer(*block);
+                _cursor = block_end;
+            }
+            else {
+                recognized = false;
+            }
+        }
+    }
+    else {
+        // Variable name lasts until the first non-allowed symbol
+        while (_probe < _input.size() && is_variable_symbol(_input[_probe])) {
+            _probe++;
+        }
+
+        if (_probe >= _input.size() && not finishing) {
+            return false;
+        }
+
+        if (_probe > _element_begin) {
+            recognized = true;
+            _consumer(PureElement(PureElementTypeVariable, _input.substr(_element_begin, _probe - _element_begin)));
+            _cursor = _probe;
+        }
+    }
+
+    // If an element has not been recognized,
+    // place just the element token itself and continue right after it
+    if (not recognized) {
+        _consumer(PureElement(PureElementTypeSlice, config.element_token));
+        _cursor = _element_begin;
+    }
+
+    _element_pending = false;
+    _slice_begin = _cursor;
+    return true;
+}
+
+void PureStreamParser::emitSlice(size_t end) {
+    if (end > _slice_begin) {
+        _consumer(PureElement(PureElementTypeSlice, _input.substr(_slice_begin, end - _slice_begin)));
+    }
+
+    _slice_begin = end;
+}
+
+void PureStreamParser::compact() {
+    // Nothing is needed after the root frame has finished
+    if (_state == StateDone) {
+        _input.clear();
+        _cursor = _slice_begin = _element_begin = _probe = 0;
+        return;
+    }
+
+    // Drop the contents already passed to the consumer,
+    // and shift all positions accordingly
+    const size_t passed_len = _slice_begin;
+    if (passed_len > 0) {
+        _input.erase(0, passed_len);
+        _cursor -= passed_len;
+        _slice_begin -= passed_len;
+        _element_begin -= std::min(_element_begin, passed_len);
+        _probe -= std::min(_probe, passed_len);
+    }
+}
+
+static bool is_variable_symbol(char symbol) {
+    return (isalpha(symbol) || isdigit(symbol) || (symbol == '_'));
+}
@@ -0,0 +1,94 @@
+//
+//  PureStreamParser.hpp
+//  PureParser
+//
+//  Copyright © 2019 JivoSite Inc. All rights reserved.
+//  <For detailed info about how this parser works, please refer to README.md file>
+//
+
+#ifndef PureStreamParser_hpp
+#define PureStreamParser_hpp
+
+#include "PureParser.hpp"
+#include "PureElement.hpp"
+#include <string>
+#include <string_view>
+#include <functional>
+#include <optional>
+
+/**
+ * The incremental parser,
+ * accepts the formula by chunks and recognizes the root frame on the fly;
+ * every top-level element is passed to the consumer as soon as it is complete,
+ * so only the unfinished tail (e.g. an open block) is kept in memory
+ */
+class PureStreamParser {
+public:
+    /// Receives the recognized top-level elements of the root frame, in order
+    typedef std::function<void(const PureElement &element)> Consumer;
+
+    /**
+     * Create the stream parser with the custom configuration,
+     * or use the built-in one with standard tokens
+     * @param consumer receiver of the recognized elements
+     */
+    PureStreamParser(Consumer consumer, PureConfig config = {});
+
+    /**
+     * Pass the next chunk of the formula
+     * @param chunk contents to be appended to the formula
+     */
+    void feed(std::string_view chunk);
+
+    /**
+     * Inform the formula has ended, so the rest of contents could be recognized
+     */
+    void finish();
+
+    /**
+     * The alias of the root frame, or empty string if there is no alias
+     */
+    const std::string &alias() const;
+
+    /**
+     * The amount of contents being kept in memory while waiting for more chunks
+     */
+    size_t pendingSize() const;
+
+private:
+    enum State {
+        StateLeading,
+        StateAlias,
+        StateBody,
+        StateDone
+    };
+
+    enum Match {
+        MatchNone,
+        MatchFound,
+        MatchNeedsMore
+    };
+
+    Match match(const std::string &token, size_t index, bool finishing) const;
+    void proceed(bool finishing);
+    bool proceedAlias(bool finishing);
+    bool proceedElement(bool finishing);
+    void emitSlice(size_t end);
+    void compact();
+
+private:
+    PureParser _parser;
+    Consumer _consumer;
+    std::string _input;
+    std::string _alias;
+    State _state;
+    size_t _cursor;
+    size_t _slice_begin;
+    bool _element_pending;
+    size_t _element_begin;
+    size_t _probe;
+    size_t _depth;
+    std::optional<bool> _element_is_block;
+};
+
+#endif /* PureStreamParser_hpp */
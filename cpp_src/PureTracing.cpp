@@ -0,0 +1,85 @@
+//
+//  PureTracing.cpp
+//  PureParser
+//
+//  Copyright © 2019 JivoSite Inc. All rights reserved.
+//  <For detailed info about how this parser works, please refer to README.md file>
+//
+
+#include "PureTracing.hpp"
+
+static PureTracer::Callback current_callback;
+static thread_local size_t current_formula_id = 0;
+
+bool PureTracer::isEnabled() {
+#ifdef PURE_PARSER_TRACING
+    return true;
+#else
+    return false;
+#endif
+}
+
+void PureTracer::setCallback(Callback callback) {
+    current_callback = std::move(callback);
+}
+
+bool PureTracer::isActive() {
+    return static_cast<bool>(current_callback);
+}
+
+size_t PureTracer::formulaId(std::string_view formula) {
+    return std::hash<std::string_view>()(formula);
+}
+
+size_t PureTracer::currentFormulaId() {
+    return current_formula_id;
+}
+
+void PureTracer::emit(PureTracePhase phase, PureTraceStage stage, size_t input_len, size_t output_len) {
+    if (current_callback) {
+        current_callback(PureTracePoint {
+            .phase = phase,
+            .stage = stage,
+            .formula_id = current_formula_id,
+            .input_len = input_len,
+            .output_len = output_len
+        });
+    }
+}
+
+PureTraceScope::PureTraceScope(PureTracePhase phase, std::string_view formula, size_t input_len) {
+    this->_active = PureTracer::isActive();
+    this->_phase = phase;
+    this->_outer_formula_id = current_formula_id;
+    this->_input_len = input_len;
+    this->_output_len = 0;
+
+    // The formula becomes the current one before the beginning is emitted
+    if (_active) {
+        current_formula_id = PureTracer::formulaId(formula);
+        PureTracer::emit(_phase, PureTraceStageBegin, _input_len, 0);
+    }
+}
+
+PureTraceScope::PureTraceScope(PureTracePhase phase, size_t input_len) {
+    this->_active = PureTracer::isActive();
+    this->_phase = phase;
+    this->_outer_formula_id = current_formula_id;
+    this->_input_len = input_len;
+    this->_output_len = 0;
+
+    if (_active) {
+        PureTracer::emit(_phase, PureTraceStageBegin, _input_len, 0);
+    }
+}
+
+PureTraceScope::~PureTraceScope() {
+    if (_active) {
+        PureTracer::emit(_phase, PureTraceStageEnd, _input_len, _output_len);
+        current_formula_id = _outer_formula_id;
+    }
+}
+
+void PureTraceScope::setOutputLength(size_t output_len) {
+    this->_output_len = output_len;
+}
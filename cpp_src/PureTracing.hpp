@@ -0,0 +1,141 @@
+//
+//  PureTracing.hpp
+//  PureParser
+//
+//  Copyright © 2019 JivoSite Inc. All rights reserved.
+//  <For detailed info about how this parser works, please refer to README.md file>
+//
+
+#ifndef PureTracing_hpp
+#define PureTracing_hpp
+
+#include <cstddef>
+#include <functional>
+#include <string_view>
+
+/**
+ * The phases being traced
+ */
+enum PureTracePhase {
+    /// Scanning the formula into the tree;
+    /// `input_len` is the formula length
+    PureTracePhaseRecognize,
+
+    /// Producing the output of compiled formula;
+    /// `input_len` is the formula length, `output_len` is the output length
+    PureTracePhaseResolve,
+
+    /// Choosing the active frame within a block;
+    /// `input_len` is the number of frames, `output_len` is the number of frames tried
+    PureTracePhaseBlock,
+
+    /// Removing extra spaces, on the fly while resolving or as separate pass;
+    /// `input_len` and `output_len` are the lengths before and after collapsing
+    PureTracePhaseCollapse
+};
+
+enum PureTraceStage {
+    PureTraceStageBegin,
+    PureTraceStageEnd
+};
+
+/**
+ * The point of trace;
+ * lengths are known at the end of phase, while at the beginning they might be zero
+ */
+struct PureTracePoint {
+    PureTracePhase phase;
+    PureTraceStage stage;
+    size_t formula_id;
+    size_t input_len;
+    size_t output_len;
+};
+
+/**
+ * The tracer, passes the trace points into the user callback;
+ * points are emitted only when the library is built with `PURE_PARSER_TRACING` defined,
+ * otherwise all the hooks are compiled out
+ */
+class PureTracer {
+public:
+    typedef std::function<void(const PureTracePoint &point)> Callback;
+
+    /**
+     * Whether the library emits the trace points
+     */
+    static bool isEnabled();
+
+    /**
+     * Set the callback, or remove it by passing `nullptr`;
+     * supposed to be set up before executing formulas, since it is not synchronized;
+     * the callback is called on the thread executing the formula
+     */
+    static void setCallback(Callback callback);
+
+    /**
+     * Whether there is the callback to emit points into
+     */
+    static bool isActive();
+
+    /**
+     * The identifier of the formula, the hash of its text
+     */
+    static size_t formulaId(std::string_view formula);
+
+    /**
+     * The identifier of the formula being processed on the current thread
+     */
+    static size_t currentFormulaId();
+
+    /**
+     * Pass the point into the callback
+     */
+    static void emit(PureTracePhase phase, PureTraceStage stage, size_t input_len, size_t output_len);
+};
+
+/**
+ * Emits the beginning and the end of the phase for the lifetime of the scope
+ */
+class PureTraceScope {
+public:
+    /**
+     * Start the phase of the formula, becoming the current one on this thread
+     */
+    PureTraceScope(PureTracePhase phase, std::string_view formula, size_t input_len);
+
+    /**
+     * Start the phase of the current formula
+     */
+    PureTraceScope(PureTracePhase phase, size_t input_len);
+
+    ~PureTraceScope();
+
+    PureTraceScope(const PureTraceScope &) = delete;
+    PureTraceScope &operator=(const PureTraceScope &) = delete;
+
+    /**
+     * Set the output length to be passed at the end
+     */
+    void setOutputLength(size_t output_len);
+
+private:
+    bool _active;
+    PureTracePhase _phase;
+    size_t _outer_formula_id;
+    size_t _input_len;
+    size_t _output_len;
+};
+
+#ifdef PURE_PARSER_TRACING
+#define PURE_TRACE_FORMULA_SCOPE(name, phase, formula, input_len) PureTraceScope name(phase, formula, input_len)
+#define PURE_TRACE_SCOPE(name, phase, input_len) PureTraceScope name(phase, input_len)
+#define PURE_TRACE_OUTPUT(name, output_len) name.setOutputLength(output_len)
+#define PURE_TRACE_POINT(phase, stage, input_len, output_len) PureTracer::emit(phase, stage, input_len, output_len)
+#else
+#define PURE_TRACE_FORMULA_SCOPE(name, phase, formula, input_len)
+#define PURE_TRACE_SCOPE(name, phase, input_len)
+#define PURE_TRACE_OUTPUT(name, output_len)
+#define PURE_TRACE_POINT(phase, stage, input_len, output_len)
+#endif
+
+#endif /* PureTracing_hpp */
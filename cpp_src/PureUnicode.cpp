@@ -0,0 +1,88 @@
+//
+//  PureUnicode.cpp
+//  PureParser
+//
+//  Copyright © 2019 JivoSite Inc. All rights reserved.
+//  <For detailed info about how this parser works, please refer to README.md file>
+//
+
+#include "PureUnicode.hpp"
+#include <cstdint>
+
+static const uint32_t kPureUnicodeReplacement = 0xFFFD;
+
+static bool read_hex(std::string_view escape, size_t offset, uint32_t &code);
+static void append_utf8(uint32_t code, std::string &target);
+
+size_t appendUnicodeEscape(std::string_view escape, std::string &target) {
+    uint32_t code = 0;
+    if (not read_hex(escape, 0, code)) {
+        return 0;
+    }
+
+    // Join the surrogate pair into the single code point,
+    // and replace the unpaired surrogates, leaving the following escape to be decoded by itself
+    size_t decoded_len = 4;
+    uint32_t low_code = 0;
+    if (code >= 0xD800 && code < 0xDC00) {
+        if (escape.substr(4, 2) == "\\u" && read_hex(escape, 6, low_code) && low_code >= 0xDC00 && low_code < 0xE000) {
+            code = 0x10000 + ((code - 0xD800) << 10) + (low_code - 0xDC00);
+            decoded_len += 6;
+        }
+        else {
+            code = kPureUnicodeReplacement;
+        }
+    }
+    else if (code >= 0xDC00 && code < 0xE000) {
+        code = kPureUnicodeReplacement;
+    }
+
+    append_utf8(code, target);
+    return decoded_len;
+}
+
+static bool read_hex(std::string_view escape, size_t offset, uint32_t &code) {
+    if (offset + 4 > escape.size()) {
+        return false;
+    }
+
+    code = 0;
+    for (const char symbol : escape.substr(offset, 4)) {
+        code <<= 4;
+        if (symbol >= '0' && symbol <= '9') {
+            code |= (symbol - '0');
+        }
+        else if (symbol >= 'a' && symbol <= 'f') {
+            code |= (symbol - 'a' + 10);
+        }
+        else if (symbol >= 'A' && symbol <= 'F') {
+            code |= (symbol - 'A' + 10);
+        }
+        else {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+static void append_utf8(uint32_t code, std::string &target) {
+    if (code < 0x80) {
+        target.push_back(static_cast<char>(code));
+    }
+    else if (code < 0x800) {
+        target.push_back(static_cast<char>(0xC0 | (code >> 6)));
+        target.push_back(static_cast<char>(0x80 | (code & 0x3F)));
+    }
+    else if (code < 0x10000) {
+        target.push_back(static_cast<char>(0xE0 | (code >> 12)));
+        target.push_back(static_cast<char>(0x80 | ((code >> 6) & 0x3F)));
+        target.push_back(static_cast<char>(0x80 | (code & 0x3F)));
+    }
+    else {
+        target.push_back(static_cast<char>(0xF0 | (code >> 18)));
+        target.push_back(static_cast<char>(0x80 | ((code >> 12) & 0x3F)));
+        target.push_back(static_cast<char>(0x80 | ((code >> 6) & 0x3F)));
+        target.push_back(static_cast<char>(0x80 | (code & 0x3F)));
+    }
+}
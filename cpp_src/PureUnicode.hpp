@@ -0,0 +1,24 @@
+//
+//  PureUnicode.hpp
+//  PureParser
+//
+//  Copyright © 2019 JivoSite Inc. All rights reserved.
+//  <For detailed info about how this parser works, please refer to README.md file>
+//
+
+#ifndef PureUnicode_hpp
+#define PureUnicode_hpp
+
+#include <string>
+#include <string_view>
+#include <cstddef>
+
+/**
+ * Decode the `\uXXXX` escape, with `escape` starting right after `\u`, and append it to `target` as UTF-8;
+ * the high surrogate followed by the `\uXXXX` low surrogate is joined into the single code point,
+ * while unpaired surrogates become the U+FFFD replacement character, so the output is always valid UTF-8
+ * @return the number of bytes decoded after `\u`, or 0 if it is not followed by exactly four hex digits
+ */
+size_t appendUnicodeEscape(std::string_view escape, std::string &target);
+
+#endif /* PureUnicode_hpp */
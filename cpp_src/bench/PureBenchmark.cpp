@@ -0,0 +1,389 @@
+//
+//  PureBenchmark.cpp
+//  PureParser
+//
+//  Copyright © 2019 JivoSite Inc. All rights reserved.
+//  <For detailed info about how this parser works, please refer to README.md file>
+//
+
+#include "PureBenchmark.hpp"
+#include "../PureReference.hpp"
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <new>
+#include <iostream>
+#include <cstring>
+#include <algorithm>
+#include <optional>
+
+#pragma mark - Allocations accounting
+
+static size_t allocations_number = 0;
+static size_t allocations_bytes = 0;
+
+void *operator new(size_t size) {
+    allocations_number++;
+    allocations_bytes += size;
+    PureAccountant::recordAllocation(size);
+
+    if (void *pointer = malloc(size ? size : 1)) {
+        return pointer;
+    }
+    else {
+        throw std::bad_alloc();
+    }
+}
+
+void *operator new[](size_t size) {
+    return operator new(size);
+}
+
+void operator delete(void *pointer) noexcept {
+    free(pointer);
+}
+
+void operator delete[](void *pointer) noexcept {
+    free(pointer);
+}
+
+void operator delete(void *pointer, size_t) noexcept {
+    free(pointer);
+}
+
+void operator delete[](void *pointer, size_t) noexcept {
+    free(pointer);
+}
+
+#pragma mark - Measuring
+
+static volatile size_t benchmark_sink = 0;
+
+template <typename Operation>
+static PureBenchmarkResult measure(const std::string &name, const std::string &mode, double min_time_ms, PurePerfCounters *counters, Operation operation) {
+    typedef std::chrono::steady_clock clock;
+
+    // Warm up the caches, and remember the output size
+    const size_t output_len = operation();
+
+    // Repeat in growing batches until the minimal time passes
+    size_t iterations = 0;
+    size_t batch_size = 1;
+    double elapsed_ns = 0;
+    const size_t base_allocations_number = allocations_number;
+    const size_t base_allocations_bytes = allocations_bytes;
+    PureAccountant::reset();
+    PurePerfSample sample;
+
+    while (elapsed_ns < min_time_ms * 1e6) {
+        if (counters) {
+            counters->start();
+        }
+
+        const auto started_at = clock::now();
+        for (size_t index = 0; index < batch_size; index++) {
+            benchmark_sink = benchmark_sink + operation();
+        }
+
+        elapsed_ns += std::chrono::duration<double, std::nano>(clock::now() - started_at).count();
+        if (counters) {
+            counters->stop(sample);
+        }
+
+        iterations += batch_size;
+        batch_size = std::min<size_t>(batch_size * 2, 1 << 16);
+    }
+
+    return PureBenchmarkResult {
+        .name = name,
+        .mode = mode,
+        .iterations = iterations,
+        .ns_per_op = elapsed_ns / iterations,
+        .bytes_per_op = double(allocations_bytes - base_allocations_bytes) / iterations,
+        .allocs_per_op = double(allocations_number - base_allocations_number) / iterations,
+        .output_len = output_len,
+        .accounting = PureAccountant::snapshot(),
+        .has_counters = (counters != nullptr),
+        .counters = sample
+    };
+}
+
+PureBenchmark::PureBenchmark(double min_time_ms, PurePerfCounters *counters) {
+    this->_min_time_ms = min_time_ms;
+    this->_counters = counters;
+}
+
+std::vector<PureBenchmarkResult> PureBenchmark::run(const PureBenchmarkScenario &scenario) const {
+    PureParser parser(scenario.config);
+    for (const auto &variable : scenario.variables) {
+        parser.assignVariable(variable.first, variable.second);
+    }
+
+    for (const auto &alias : scenario.aliases) {
+        parser.enableAlias(alias);
+    }
+
+    const PureFormula formula = parser.compile(scenario.formula);
+    const bool collapse_spaces = scenario.collapse_spaces;
+    std::vector<PureBenchmarkResult> results;
+
+    // The original engine, as the baseline for comparing
+    PureReferenceParser reference(scenario.config);
+    for (const auto &variable : scenario.variables) {
+        reference.assignVariable(variable.first, variable.second);
+    }
+
+    for (const auto &alias : scenario.aliases) {
+        reference.enableAlias(alias);
+    }
+
+    results.push_back(measure(scenario.name, "reference", _min_time_ms, _counters, [&]() -> size_t {
+        return reference.execute(scenario.formula, collapse_spaces, false).size();
+    }));
+
+    // Recognize and resolve the textual formula every time
+    results.push_back(measure(scenario.name, "execute", _min_time_ms, _counters, [&]() -> size_t {
+        return parser.execute(scenario.formula, collapse_spaces, false).size();
+    }));
+
+    // Resolve the compiled formula into the string
+    results.push_back(measure(scenario.name, "compiled", _min_time_ms, _counters, [&]() -> size_t {
+        return parser.execute(formula, collapse_spaces, false).size();
+    }));
+
+    // Resolve the compiled formula into the same string again and again
+    std::string output;
+    results.push_back(measure(scenario.name, "reused", _min_time_ms, _counters, [&]() -> size_t {
+        parser.execute(formula, collapse_spaces, false, output);
+        return output.size();
+    }));
+
+    // Pass the compiled formula output by chunks
+    results.push_back(measure(scenario.name, "chunked", _min_time_ms, _counters, [&]() -> size_t {
+        size_t output_len = 0;
+        parser.execute(formula, collapse_spaces, false, 4096, [&](std::string_view chunk) { output_len += chunk.size(); });
+        return output_len;
+    }));
+
+    // Resolve the compiled formula into the fixed memory,
+    // sized by the sizing run so that the whole output is written rather than truncated
+    std::vector<char> buffer(4096);
+    buffer.resize(std::max(buffer.size(), parser.execute(formula, collapse_spaces, false, buffer.data(), buffer.size())));
+    results.push_back(measure(scenario.name, "buffer", _min_time_ms, _counters, [&]() -> size_t {
+        return parser.execute(formula, collapse_spaces, false, buffer.data(), buffer.size());
+    }));
+
+    // Collect the compiled formula output as `iovec` list
+    std::vector<struct iovec> vectors;
+    results.push_back(measure(scenario.name, "vectored", _min_time_ms, _counters, [&]() -> size_t {
+        parser.execute(formula, collapse_spaces, vectors);
+
+        size_t output_len = 0;
+        for (const auto &vector : vectors) {
+            output_len += vector.iov_len;
+        }
+
+        return output_len;
+    }));
+
+    // Bind variables and aliases from JSON, and resolve the compiled formula with them
+    std::string json = "{";
+    for (const auto &variable : scenario.variables) {
+        json += (json.size() > 1 ? ",\"" : "\"") + variable.first + "\":\"";
+        for (const char symbol : variable.second) {
+            json += (symbol == '"' || symbol == '\\' ? std::string("\\") + symbol : std::string(1, symbol));
+        }
+        json += "\"";
+    }
+
+    for (const auto &alias : scenario.aliases) {
+        json += (json.size() > 1 ? ",\"" : "\"") + alias + "\":true";
+    }
+    json += "}";
+
+    // Assign the values again after every reset, copying them into the memory the variables already own
+    PureBindings bindings;
+    results.push_back(measure(scenario.name, "assign", _min_time_ms, _counters, [&]() -> size_t {
+        bindings.reset();
+        for (const auto &variable : scenario.variables) {
+            bindings.assignVariable(variable.first, variable.second);
+        }
+
+        for (const auto &alias : scenario.aliases) {
+            bindings.enableAlias(alias);
+        }
+
+        parser.execute(formula, bindings, collapse_spaces, output);
+        return output.size();
+    }));
+
+    results.push_back(measure(scenario.name, "json", _min_time_ms, _counters, [&]() -> size_t {
+        bindings.reset();
+        bindings.assignJson(json);
+        parser.execute(formula, bindings, collapse_spaces, output);
+        return output.size();
+    }));
+
+    // Same, but the values point right into the JSON
+    results.push_back(measure(scenario.name, "jsonview", _min_time_ms, _counters, [&]() -> size_t {
+        bindings.reset();
+        bindings.assignJsonView(json);
+        parser.execute(formula, bindings, collapse_spaces, output);
+        return output.size();
+    }));
+
+    return results;
+}
+
+#pragma mark - Reporting
+
+void PureBenchmark::printText(std::ostream &stream, const std::vector<PureBenchmarkResult> &results) {
+    stream << std::left << std::setw(36) << "scenario" << std::setw(10) << "mode"
+        << std::right << std::setw(14) << "ns/op" << std::setw(14) << "bytes/op" << std::setw(12) << "allocs/op" << std::setw(12) << "output" << std::endl;
+
+    for (const auto &result : results) {
+        stream << std::left << std::setw(36) << result.name << std::setw(10) << result.mode
+            << std::right << std::fixed << std::setprecision(1)
+            << std::setw(14) << result.ns_per_op
+            << std::setw(14) << result.bytes_per_op
+            << std::setw(12) << result.allocs_per_op
+            << std::setw(12) << result.output_len << std::endl;
+    }
+
+    if (not results.empty() and results.front().has_counters) {
+        // Hardware events, per single execution
+        stream << std::endl << std::left << std::setw(36) << "scenario" << std::setw(10) << "mode"
+            << std::right << std::setw(14) << "cycles/op" << std::setw(14) << "instrs/op" << std::setw(8) << "IPC"
+            << std::setw(14) << "cache-miss/op" << std::setw(14) << "branch-miss/op" << std::endl;
+
+        for (const auto &result : results) {
+            const uint64_t * const values = result.counters.values;
+            stream << std::left << std::setw(36) << result.name << std::setw(10) << result.mode
+                << std::right << std::fixed << std::setprecision(1)
+                << std::setw(14) << double(values[PurePerfCycles]) / result.iterations
+                << std::setw(14) << double(values[PurePerfInstructions]) / result.iterations
+                << std::setprecision(2)
+                << std::setw(8) << (values[PurePerfCycles] ? double(values[PurePerfInstructions]) / values[PurePerfCycles] : 0)
+                << std::setprecision(3)
+                << std::setw(14) << double(values[PurePerfCacheMisses]) / result.iterations
+                << std::setw(14) << double(values[PurePerfBranchMisses]) / result.iterations << std::endl;
+        }
+    }
+
+    if (not PureAccountant::isEnabled()) {
+        return;
+    }
+
+    // Phases details, per single execution
+    const char * const phase_captions[PurePhasesNumber] = { "other", "recognize", "resolve", "collapse" };
+    stream << std::endl << std::left << std::setw(36) << "scenario" << std::setw(10) << "mode" << std::setw(11) << "phase"
+        << std::right << std::setw(14) << "ns/op" << std::setw(14) << "bytes/op" << std::setw(12) << "allocs/op" << std::endl;
+
+    for (const auto &result : results) {
+        for (size_t phase = PurePhaseRecognize; phase < PurePhasesNumber; phase++) {
+            const PurePhaseUsage &usage = result.accounting.phases[phase];
+            stream << std::left << std::setw(36) << result.name << std::setw(10) << result.mode << std::setw(11) << phase_captions[phase]
+                << std::right << std::fixed << std::setprecision(1)
+                << std::setw(14) << usage.elapsed_ns / result.iterations
+                << std::setw(14) << double(usage.allocated_bytes) / result.iterations
+                << std::setw(12) << double(usage.allocations) / result.iterations << std::endl;
+        }
+    }
+}
+
+void PureBenchmark::printJson(std::ostream &stream, const std::vector<PureBenchmarkResult> &results) {
+    stream << "[" << std::endl;
+    for (size_t index = 0; index < results.size(); index++) {
+        const PureBenchmarkResult &result = results[index];
+        stream << std::fixed << std::setprecision(3)
+            << "  {\"scenario\": \"" << result.name << "\""
+            << ", \"mode\": \"" << result.mode << "\""
+            << ", \"iterations\": " << result.iterations
+            << ", \"ns_per_op\": " << result.ns_per_op
+            << ", \"bytes_per_op\": " << result.bytes_per_op
+            << ", \"allocs_per_op\": " << result.allocs_per_op
+            << ", \"output_len\": " << result.output_len;
+
+        if (result.has_counters) {
+            const uint64_t * const values = result.counters.values;
+            stream << ", \"cycles_per_op\": " << double(values[PurePerfCycles]) / result.iterations
+                << ", \"instructions_per_op\": " << double(values[PurePerfInstructions]) / result.iterations
+                << ", \"cache_misses_per_op\": " << double(values[PurePerfCacheMisses]) / result.iterations
+                << ", \"branch_misses_per_op\": " << double(values[PurePerfBranchMisses]) / result.iterations;
+        }
+
+        if (PureAccountant::isEnabled()) {
+            const char * const phase_captions[PurePhasesNumber] = { "other", "recognize", "resolve", "collapse" };
+            stream << ", \"phases\": {";
+            for (size_t phase = PurePhaseRecognize; phase < PurePhasesNumber; phase++) {
+                const PurePhaseUsage &usage = result.accounting.phases[phase];
+                stream << (phase > PurePhaseRecognize ? ", " : "") << "\"" << phase_captions[phase] << "\": {"
+                    << "\"ns_per_op\": " << usage.elapsed_ns / result.iterations
+                    << ", \"bytes_per_op\": " << double(usage.allocated_bytes) / result.iterations
+                    << ", \"allocs_per_op\": " << double(usage.allocations) / result.iterations << "}";
+            }
+            stream << "}";
+        }
+
+        stream << "}" << (index + 1 < results.size() ? "," : "") << std::endl;
+    }
+    stream << "]" << std::endl;
+}
+
+#pragma mark - Entry point
+
+int main(int argc, const char *argv[]) {
+    bool json_format = false;
+    bool hardware_counters = false;
+    double min_time_ms = 200;
+    std::string filter;
+
+    for (int index = 1; index < argc; index++) {
+        const std::string argument = argv[index];
+        if (argument == "--json") {
+            json_format = true;
+        }
+        else if (argument == "--counters") {
+            hardware_counters = true;
+        }
+        else if (argument.find("--min-time=") == 0) {
+            min_time_ms = atof(argument.c_str() + strlen("--min-time="));
+        }
+        else if (argument.find("--filter=") == 0) {
+            filter = argument.substr(strlen("--filter="));
+        }
+        else {
+            std::cerr << "Usage: " << argv[0] << " [--json] [--counters] [--min-time=ms] [--filter=substring]" << std::endl;
+            return 1;
+        }
+    }
+
+    std::optional<PurePerfCounters> counters;
+    if (hardware_counters) {
+        counters.emplace();
+        if (not counters->isAvailable()) {
+            std::cerr << "Hardware counters are not available on this system, measuring without them" << std::endl;
+            counters.reset();
+        }
+    }
+
+    const PureBenchmark benchmark(min_time_ms, counters ? &counters.value() : nullptr);
+    std::vector<PureBenchmarkResult> all_results;
+    for (const auto &scenario : pure_benchmark_scenarios()) {
+        if (scenario.name.find(filter) == std::string::npos) {
+            continue;
+        }
+
+        const std::vector<PureBenchmarkResult> results = benchmark.run(scenario);
+        all_results.insert(all_results.end(), results.begin(), results.end());
+    }
+
+    if (json_format) {
+        PureBenchmark::printJson(std::cout, all_results);
+    }
+    else {
+        PureBenchmark::printText(std::cout, all_results);
+    }
+
+    return 0;
+}
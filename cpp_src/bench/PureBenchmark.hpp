@@ -0,0 +1,90 @@
+//
+//  PureBenchmark.hpp
+//  PureParser
+//
+//  Copyright © 2019 JivoSite Inc. All rights reserved.
+//  <For detailed info about how this parser works, please refer to README.md file>
+//
+
+#ifndef PureBenchmark_hpp
+#define PureBenchmark_hpp
+
+#include "../PureParser.hpp"
+#include "../PureAccounting.hpp"
+#include "PurePerfCounters.hpp"
+#include <string>
+#include <vector>
+#include <map>
+#include <set>
+#include <ostream>
+
+/**
+ * The formula to measure, along with everything it needs for executing
+ */
+struct PureBenchmarkScenario {
+    std::string name;
+    PureConfig config = {};
+    std::string formula = {};
+    std::map<std::string, std::string> variables = {};
+    std::set<std::string> aliases = {};
+    bool collapse_spaces = false;
+};
+
+/**
+ * The measured values of a scenario, all normalized per single execution
+ */
+struct PureBenchmarkResult {
+    std::string name;
+    std::string mode;
+    size_t iterations;
+    double ns_per_op;
+    double bytes_per_op;
+    double allocs_per_op;
+    size_t output_len;
+
+    /// Resources of every phase, in total for all iterations;
+    /// collected only if the library marks the phases
+    PureAccounting accounting;
+
+    /// Hardware events, in total for all iterations;
+    /// collected only if the counters are requested and available
+    bool has_counters;
+    PurePerfSample counters;
+};
+
+/**
+ * All built-in scenarios:
+ * the documented examples, and the scaled ones
+ */
+std::vector<PureBenchmarkScenario> pure_benchmark_scenarios();
+
+/**
+ * The benchmark runner,
+ * executes every scenario in different modes until the minimal time passes
+ */
+class PureBenchmark {
+public:
+    /**
+     * Create the runner
+     * @param min_time_ms how long to repeat every measurement, at least
+     * @param counters hardware counters to read around every measurement, optional
+     */
+    explicit PureBenchmark(double min_time_ms, PurePerfCounters *counters = nullptr);
+
+    /**
+     * Measure the scenario in every supported mode
+     */
+    std::vector<PureBenchmarkResult> run(const PureBenchmarkScenario &scenario) const;
+
+    /**
+     * Print the results as a table for humans, or as JSON for tools
+     */
+    static void printText(std::ostream &stream, const std::vector<PureBenchmarkResult> &results);
+    static void printJson(std::ostream &stream, const std::vector<PureBenchmarkResult> &results);
+
+private:
+    double _min_time_ms;
+    PurePerfCounters *_counters;
+};
+
+#endif /* PureBenchmark_hpp */
@@ -0,0 +1,298 @@
+//
+//  PureBenchmarkScenarios.cpp
+//  PureParser
+//
+//  Copyright © 2019 JivoSite Inc. All rights reserved.
+//  <For detailed info about how this parser works, please refer to README.md file>
+//
+
+#include "PureBenchmark.hpp"
+#include "PureCorpus.hpp"
+
+static PureConfig custom_config();
+static std::string replace_tokens(std::string formula, const PureConfig &config);
+
+#pragma mark - Documented examples
+
+static const char * const kReminderFormula = "$[Agent $creatorName ## You] changed reminder $[«$comment»] $[:target: for $[$targetName ## you]] on $date at $time";
+
+static void append_examples(std::vector<PureBenchmarkScenario> *scenarios) {
+    scenarios->push_back({
+        .name = "example/plain",
+        .formula = "Hello world",
+        .collapse_spaces = true
+    });
+
+    scenarios->push_back({
+        .name = "example/variable",
+        .formula = "Hello, $name",
+        .variables = { {"name", "Stan"} },
+        .collapse_spaces = true
+    });
+
+    scenarios->push_back({
+        .name = "example/block_with_variable",
+        .formula = "Please wait, $name: we're calling $[$anotherName ## another guy]",
+        .variables = { {"name", "Stan"}, {"anotherName", "Paul"} },
+        .collapse_spaces = true
+    });
+
+    scenarios->push_back({
+        .name = "example/block_with_plain",
+        .formula = "Please wait, $name: we're calling $[$anotherName ## another guy]",
+        .variables = { {"name", "Stan"} },
+        .collapse_spaces = true
+    });
+
+    scenarios->push_back({
+        .name = "example/block_with_rich",
+        .formula = "Congrats! You saved it $[in folder '$folder'].",
+        .variables = { {"folder", "Documents"} },
+        .collapse_spaces = true
+    });
+
+    scenarios->push_back({
+        .name = "example/inactive_block",
+        .formula = "Congrats! You saved it $[in folder '$folder'].",
+        .collapse_spaces = true
+    });
+
+    scenarios->push_back({
+        .name = "example/complex_active_alias",
+        .formula = kReminderFormula,
+        .variables = { {"comment", "Check his payment"}, {"date", "today"}, {"time", "11:30 AM"} },
+        .aliases = { "target" },
+        .collapse_spaces = true
+    });
+
+    scenarios->push_back({
+        .name = "example/complex_inactive_alias",
+        .formula = kReminderFormula,
+        .variables = { {"comment", "Check his payment"}, {"date", "today"}, {"time", "11:30 AM"} },
+        .collapse_spaces = true
+    });
+
+    scenarios->push_back({
+        .name = "example/coupons",
+        .formula = "$[$name has ## You have] $[$number coupon(s) ## no coupons] expiring on $date",
+        .variables = { {"number", "7"}, {"date", "11/11/19"} },
+        .collapse_spaces = true
+    });
+}
+
+#pragma mark - Scaled scenarios
+
+static void append_scaled(std::vector<PureBenchmarkScenario> *scenarios) {
+    // Long slices between few elements
+    std::string long_text;
+    while (long_text.size() < 64 * 1024) {
+        long_text += "Lorem ipsum dolor sit amet, consectetur adipiscing elit. ";
+    }
+
+    scenarios->push_back({
+        .name = "scaled/long_slices_64k",
+        .formula = "Dear $name, " + long_text + "$[Regards, $agent ## Regards] " + long_text,
+        .variables = { {"name", "Stan"}, {"agent", "Paul"} },
+        .collapse_spaces = false
+    });
+
+    // Blocks nested into each other
+    std::string nested_formula = "$value";
+    for (size_t depth = 0; depth < 32; depth++) {
+        nested_formula = "level $[" + nested_formula + " ## fallback]";
+    }
+
+    scenarios->push_back({
+        .name = "scaled/deep_nesting_32",
+        .formula = nested_formula,
+        .variables = { {"value", "deepest"} },
+        .collapse_spaces = false
+    });
+
+    // Values far beyond the small string capacity, to see whether assigning them again allocates
+    scenarios->push_back({
+        .name = "scaled/long_values_4k",
+        .formula = "From $sender: $body",
+        .variables = { {"sender", std::string(256, 's')}, {"body", std::string(4096, 'b')} },
+        .collapse_spaces = false
+    });
+
+    // Block with many frames, where only the last one is active
+    std::string frames_formula = "Result: $[";
+    for (size_t index = 0; index < 100; index++) {
+        frames_formula += "frame $missing" + std::to_string(index) + " ## ";
+    }
+    frames_formula += "fallback]";
+
+    scenarios->push_back({
+        .name = "scaled/many_frames_100",
+        .formula = frames_formula,
+        .collapse_spaces = false
+    });
+
+    // Many variables within the root frame
+    PureBenchmarkScenario variables_scenario {
+        .name = "scaled/many_variables_200",
+        .collapse_spaces = false
+    };
+
+    for (size_t index = 0; index < 200; index++) {
+        const std::string name = "var" + std::to_string(index);
+        variables_scenario.formula += "$" + name + " ";
+        variables_scenario.variables[name] = "value" + std::to_string(index);
+    }
+
+    scenarios->push_back(variables_scenario);
+
+    // The same spaces-heavy formula, with and without collapsing
+    std::string spaces_formula;
+    for (size_t index = 0; index < 100; index++) {
+        spaces_formula += "  word  ,  $[ $name   ## nobody ]  \t said  ! \n";
+    }
+
+    scenarios->push_back({
+        .name = "scaled/spaces_collapse_off",
+        .formula = spaces_formula,
+        .variables = { {"name", "Stan"} },
+        .collapse_spaces = false
+    });
+
+    scenarios->push_back({
+        .name = "scaled/spaces_collapse_on",
+        .formula = spaces_formula,
+        .variables = { {"name", "Stan"} },
+        .collapse_spaces = true
+    });
+
+    // The same formula, with default and custom tokens
+    scenarios->push_back({
+        .name = "tokens/default",
+        .formula = kReminderFormula,
+        .variables = { {"creatorName", "Stan"}, {"comment", "Check his payment"}, {"date", "today"}, {"time", "11:30 AM"} },
+        .aliases = { "target" },
+        .collapse_spaces = true
+    });
+
+    scenarios->push_back({
+        .name = "tokens/custom",
+        .config = custom_config(),
+        .formula = replace_tokens(kReminderFormula, custom_config()),
+        .variables = { {"creatorName", "Stan"}, {"comment", "Check his payment"}, {"date", "today"}, {"time", "11:30 AM"} },
+        .aliases = { "target" },
+        .collapse_spaces = true
+    });
+}
+
+#pragma mark - Generated scenarios
+
+static PureBenchmarkScenario make_corpus_scenario(std::string name, PureCorpusOptions options, bool collapse_spaces) {
+    PureCorpus corpus(options);
+    PureCorpusSample sample = corpus.next();
+
+    return PureBenchmarkScenario {
+        .name = name,
+        .config = options.config,
+        .formula = sample.formula,
+        .variables = sample.variables,
+        .aliases = sample.aliases,
+        .collapse_spaces = collapse_spaces
+    };
+}
+
+static void append_corpus(std::vector<PureBenchmarkScenario> *scenarios) {
+    // Every sweep changes only one dimension of the default options
+    for (const size_t formula_size : { 1024, 4096, 16384, 65536 }) {
+        PureCorpusOptions options;
+        options.formula_size = formula_size;
+        scenarios->push_back(make_corpus_scenario("corpus/size/" + std::to_string(formula_size), options, false));
+    }
+
+    for (const size_t nesting_depth : { 1, 2, 4, 8, 16 }) {
+        PureCorpusOptions options;
+        options.nesting_depth = nesting_depth;
+        scenarios->push_back(make_corpus_scenario("corpus/depth/" + std::to_string(nesting_depth), options, false));
+    }
+
+    for (const size_t frames_per_block : { 2, 8, 32 }) {
+        PureCorpusOptions options;
+        options.frames_per_block = frames_per_block;
+        scenarios->push_back(make_corpus_scenario("corpus/frames/" + std::to_string(frames_per_block), options, false));
+    }
+
+    for (const size_t alias_percent : { 0, 50, 100 }) {
+        PureCorpusOptions options;
+        options.alias_density = alias_percent / 100.0;
+        scenarios->push_back(make_corpus_scenario("corpus/aliases/" + std::to_string(alias_percent), options, false));
+    }
+
+    for (const size_t variables_number : { 8, 64, 512 }) {
+        PureCorpusOptions options;
+        options.variables_number = variables_number;
+        scenarios->push_back(make_corpus_scenario("corpus/variables/" + std::to_string(variables_number), options, false));
+    }
+
+    const std::pair<const char *, PureCorpusSpaces> all_spaces[] = {
+        { "single", PureCorpusSpacesSingle },
+        { "runs", PureCorpusSpacesRuns },
+        { "mixed", PureCorpusSpacesMixed }
+    };
+
+    for (const auto &spaces : all_spaces) {
+        PureCorpusOptions options;
+        options.spaces = spaces.second;
+        scenarios->push_back(make_corpus_scenario(std::string("corpus/spaces/") + spaces.first, options, true));
+    }
+
+    PureCorpusOptions custom_options;
+    custom_options.config = custom_config();
+    scenarios->push_back(make_corpus_scenario("corpus/tokens/custom", custom_options, false));
+}
+
+std::vector<PureBenchmarkScenario> pure_benchmark_scenarios() {
+    std::vector<PureBenchmarkScenario> scenarios;
+    append_examples(&scenarios);
+    append_scaled(&scenarios);
+    append_corpus(&scenarios);
+    return scenarios;
+}
+
+static PureConfig custom_config() {
+    PureConfig config;
+    config.element_token = "@";
+    config.block_opener_token = "{{";
+    config.block_closer_token = "}}";
+    config.separator_token = "||";
+    config.alias_token = "~";
+    return config;
+}
+
+static std::string replace_tokens(std::string formula, const PureConfig &config) {
+    // Translate the formula written with default tokens
+    const PureConfig default_config;
+    const std::pair<std::string, std::string> replacements[] = {
+        { default_config.separator_token, config.separator_token },
+        { default_config.block_opener_token, config.block_opener_token },
+        { default_config.block_closer_token, config.block_closer_token },
+        { default_config.element_token, config.element_token },
+        { default_config.alias_token, config.alias_token }
+    };
+
+    std::string result;
+    for (size_t index = 0; index < formula.size();) {
+        bool replaced = false;
+        for (const auto &replacement : replacements) {
+            if (formula.compare(index, replacement.first.size(), replacement.first) == 0) {
+                result += replacement.second;
+                index += replacement.first.size();
+                replaced = true;
+                break;
+            }
+        }
+
+        if (not replaced) {
+            result += formula[index++];
+        }
+    }
+
+    return result;
+}
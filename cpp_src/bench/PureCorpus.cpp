@@ -0,0 +1,192 @@
+//
+//  PureCorpus.cpp
+//  PureParser
+//
+//  Copyright © 2019 JivoSite Inc. All rights reserved.
+//  <For detailed info about how this parser works, please refer to README.md file>
+//
+
+#include "PureCorpus.hpp"
+#include <algorithm>
+#include <cctype>
+
+static const char * const kCorpusWords[] = {
+    "agent", "you", "changed", "reminder", "for", "on", "at", "the", "client", "has",
+    "coupon", "payment", "folder", "saved", "message", "chat", "please", "wait", "calling", "today"
+};
+
+static const char kCorpusPunctuation[] = { ',', '.', '!', '?' };
+
+/// Blocks are not generated into frames shorter than that
+static const size_t kCorpusMinimalBudget = 16;
+
+PureCorpus::PureCorpus(PureCorpusOptions options)
+: _options(options) {
+    this->_state = options.seed;
+}
+
+PureCorpusSample PureCorpus::next() {
+    PureCorpusSample sample;
+    _root_variables.clear();
+    sample.formula = generateFrame(_options.formula_size, 0);
+
+    // The root frame may get the alias as well
+    if (_options.noise > 0 && randomChance(_options.noise)) {
+        const PureConfig &config = _options.config;
+        const std::string alias = randomChance(0.2) ? std::string() : aliasName(randomBelow(_options.variables_number + 1));
+        sample.formula = generateSpaces() + config.alias_token + alias + config.alias_token + sample.formula;
+    }
+
+    // Assign the part of variables, and enable the part of aliases;
+    // variables of the root frame are always assigned, otherwise the output would be empty
+    for (size_t index = 0; index < _options.variables_number; index++) {
+        if (_root_variables.count(index) > 0 || randomChance(_options.assigned_ratio)) {
+            sample.variables[variableName(index)] = generateWord();
+        }
+
+        if (randomChance(_options.assigned_ratio)) {
+            sample.aliases.insert(aliasName(index));
+        }
+    }
+
+    return sample;
+}
+
+uint64_t PureCorpus::random() {
+    // SplitMix64, to get the same sequence on every platform
+    uint64_t value = (_state += 0x9E3779B97F4A7C15ull);
+    value = (value ^ (value >> 30)) * 0xBF58476D1CE4E5B9ull;
+    value = (value ^ (value >> 27)) * 0x94D049BB133111EBull;
+    return value ^ (value >> 31);
+}
+
+size_t PureCorpus::randomBelow(size_t limit) {
+    return (limit > 0) ? size_t(random() % limit) : 0;
+}
+
+bool PureCorpus::randomChance(double probability) {
+    return (random() >> 11) * (1.0 / 9007199254740992.0) < probability;
+}
+
+std::string PureCorpus::generateFrame(size_t budget, size_t depth) {
+    const PureConfig &config = _options.config;
+    const bool can_nest = (depth < _options.nesting_depth);
+
+    // The first block is placed in advance, so the nesting depth is always reached
+    std::string frame = generateWord() + generateSpaces();
+    if (can_nest) {
+        frame += generateBlock(budget / 2, depth) + generateSpaces();
+    }
+
+    while (frame.size() < budget) {
+        if (_options.noise > 0 && randomChance(_options.noise)) {
+            frame += generateNoise();
+            continue;
+        }
+
+        const size_t kind = randomBelow(100);
+        if (kind < 55) {
+            frame += generateWord() + generateSpaces();
+        }
+        else if (kind < 70) {
+            // Attach the punctuation to the previous word,
+            // or separate it by spaces sometimes
+            if (_options.spaces == PureCorpusSpacesMixed && randomChance(0.3)) {
+                frame += generateSpaces();
+            }
+            else {
+                while (not frame.empty() && isspace(frame.back())) {
+                    frame.pop_back();
+                }
+            }
+
+            frame += kCorpusPunctuation[randomBelow(sizeof(kCorpusPunctuation))];
+            frame += generateSpaces();
+        }
+        else if (kind < 85 && _options.variables_number > 0) {
+            const size_t variable_index = randomBelow(_options.variables_number);
+            frame += config.element_token + variableName(variable_index) + generateSpaces();
+
+            if (depth == 0) {
+                _root_variables.insert(variable_index);
+            }
+        }
+        else if (can_nest && budget - frame.size() >= kCorpusMinimalBudget) {
+            frame += generateBlock((budget - frame.size()) / 2, depth) + generateSpaces();
+        }
+    }
+
+    return frame;
+}
+
+std::string PureCorpus::generateBlock(size_t budget, size_t depth) {
+    const PureConfig &config = _options.config;
+    const size_t frames_number = std::max<size_t>(1, _options.frames_per_block);
+    const size_t frame_budget = std::max<size_t>(1, budget / frames_number);
+
+    std::string block = config.element_token + config.block_opener_token;
+    for (size_t index = 0; index < frames_number; index++) {
+        if (index > 0) {
+            block += generateSpaces() + config.separator_token + generateSpaces();
+        }
+
+        if (_options.variables_number > 0 && randomChance(_options.alias_density)) {
+            block += config.alias_token + aliasName(randomBelow(_options.variables_number)) + config.alias_token + generateSpaces();
+        }
+
+        // Only the first frame keeps nesting, to avoid the exponential growth
+        block += generateFrame(frame_budget, (index == 0) ? depth + 1 : _options.nesting_depth);
+    }
+
+    return block + config.block_closer_token;
+}
+
+std::string PureCorpus::generateWord() {
+    return kCorpusWords[randomBelow(sizeof(kCorpusWords) / sizeof(*kCorpusWords))];
+}
+
+std::string PureCorpus::generateSpaces() {
+    switch (_options.spaces) {
+        case PureCorpusSpacesSingle:
+            return " ";
+
+        case PureCorpusSpacesRuns:
+            return std::string(1 + randomBelow(4), ' ');
+
+        case PureCorpusSpacesMixed: {
+            static const char symbols[] = { ' ', ' ', ' ', '\t', '\n' };
+            std::string spaces(1 + randomBelow(4), ' ');
+            for (auto &symbol : spaces) {
+                symbol = symbols[randomBelow(sizeof(symbols))];
+            }
+
+            return spaces;
+        }
+    }
+
+    return " ";
+}
+
+std::string PureCorpus::generateNoise() {
+    // Tokens being out of their places:
+    // unmatched closers and openers, element token without element, separators, aliases
+    const PureConfig &config = _options.config;
+    switch (randomBelow(8)) {
+        case 0: return config.element_token + generateSpaces();
+        case 1: return config.element_token + kCorpusPunctuation[randomBelow(sizeof(kCorpusPunctuation))];
+        case 2: return config.block_closer_token;
+        case 3: return config.block_opener_token;
+        case 4: return config.element_token + config.block_opener_token + generateWord();
+        case 5: return config.alias_token;
+        case 6: return config.separator_token;
+        default: return config.element_token;
+    }
+}
+
+std::string PureCorpus::variableName(size_t index) const {
+    return "var" + std::to_string(index);
+}
+
+std::string PureCorpus::aliasName(size_t index) const {
+    return "alias" + std::to_string(index);
+}
@@ -0,0 +1,107 @@
+//
+//  PureCorpus.hpp
+//  PureParser
+//
+//  Copyright © 2019 JivoSite Inc. All rights reserved.
+//  <For detailed info about how this parser works, please refer to README.md file>
+//
+
+#ifndef PureCorpus_hpp
+#define PureCorpus_hpp
+
+#include "../PureParser.hpp"
+#include <string>
+#include <map>
+#include <set>
+#include <cstdint>
+
+/**
+ * The way spaces are placed between words of generated formulas
+ */
+enum PureCorpusSpaces {
+    /// Exactly one space between words
+    PureCorpusSpacesSingle,
+
+    /// Sequences of several spaces
+    PureCorpusSpacesRuns,
+
+    /// Sequences of spaces, tabs and newlines, also before punctuation
+    PureCorpusSpacesMixed
+};
+
+/**
+ * The dimensions of generated formulas
+ */
+struct PureCorpusOptions {
+    /// The same seed always produces the same formulas
+    uint64_t seed = 1;
+
+    /// Approximate formula length, in bytes
+    size_t formula_size = 1024;
+
+    /// How deep the blocks could be nested into each other
+    size_t nesting_depth = 2;
+
+    /// How many frames every block has
+    size_t frames_per_block = 3;
+
+    /// The probability of a frame within block to have an alias
+    double alias_density = 0.2;
+
+    /// How many different variables are used
+    size_t variables_number = 8;
+
+    /// The share of variables to be assigned, and of aliases to be enabled
+    double assigned_ratio = 0.7;
+
+    /// How spaces are placed
+    PureCorpusSpaces spaces = PureCorpusSpacesSingle;
+
+    /// The probability of placing stray tokens and leading aliases, to reach the edge cases
+    double noise = 0;
+
+    /// Tokens to generate formulas with
+    PureConfig config;
+};
+
+/**
+ * The generated formula along with variables and aliases to execute it with
+ */
+struct PureCorpusSample {
+    std::string formula;
+    std::map<std::string, std::string> variables;
+    std::set<std::string> aliases;
+};
+
+/**
+ * The deterministic generator of valid formulas with controlled dimensions
+ */
+class PureCorpus {
+public:
+    explicit PureCorpus(PureCorpusOptions options);
+
+    /**
+     * Generate the next sample
+     */
+    PureCorpusSample next();
+
+private:
+    uint64_t random();
+    size_t randomBelow(size_t limit);
+    bool randomChance(double probability);
+
+    std::string generateFrame(size_t budget, size_t depth);
+    std::string generateBlock(size_t budget, size_t depth);
+    std::string generateWord();
+    std::string generateSpaces();
+    std::string generateNoise();
+    std::string variableName(size_t index) const;
+    std::string aliasName(size_t index) const;
+
+private:
+    PureCorpusOptions _options;
+    uint64_t _state;
+    std::set<size_t> _root_variables;
+};
+
+#endif /* PureCorpus_hpp */
@@ -0,0 +1,355 @@
+//
+//  PureDifferential.cpp
+//  PureParser
+//
+//  Copyright © 2019 JivoSite Inc. All rights reserved.
+//  <For detailed info about how this parser works, please refer to README.md file>
+//
+
+#include "../PureBindings.hpp"
+#include "../PureParser.hpp"
+#include "../PureReference.hpp"
+#include "../PureSession.hpp"
+#include "../PureStreamParser.hpp"
+#include "PureCorpus.hpp"
+#include <chrono>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <iterator>
+#include <random>
+#include <vector>
+
+#pragma mark - Local Types
+
+typedef struct {
+    std::string formula;
+    std::map<std::string, std::string> variables;
+    std::set<std::string> aliases;
+    PureConfig config;
+    bool collapse_spaces;
+} differential_case_t;
+
+typedef std::string(*differential_engine_func_t)(const differential_case_t &);
+
+typedef struct {
+    std::string caption;
+    differential_engine_func_t executor;
+    double elapsed_ns;
+    size_t mismatches;
+} differential_engine_t;
+
+#pragma mark - Local Helpers
+
+template <typename Parser>
+static void assign_bindings(Parser &parser, const differential_case_t &test_case) {
+    for (const auto &variable : test_case.variables) {
+        parser.assignVariable(variable.first, variable.second);
+    }
+
+    for (const auto &alias : test_case.aliases) {
+        parser.enableAlias(alias);
+    }
+}
+
+static PureConfig custom_config() {
+    PureConfig config;
+    config.element_token = "@";
+    config.block_opener_token = "{{";
+    config.block_closer_token = "}}";
+    config.separator_token = "||";
+    config.alias_token = "~";
+    return config;
+}
+
+static differential_case_t make_corpus_case(uint64_t seed, double noise) {
+    // Vary the dimensions from case to case
+    PureCorpusOptions options;
+    options.seed = seed;
+    options.formula_size = 32 << (seed % 6);
+    options.nesting_depth = seed % 5;
+    options.frames_per_block = 1 + seed % 4;
+    options.alias_density = (seed % 3) * 0.3;
+    options.variables_number = 1 + seed % 7;
+    options.assigned_ratio = 0.6;
+    options.spaces = PureCorpusSpaces(seed % 3);
+    options.noise = noise;
+    if (seed % 4 == 3) {
+        options.config = custom_config();
+    }
+
+    PureCorpus corpus(options);
+    const PureCorpusSample sample = corpus.next();
+
+    return differential_case_t {
+        .formula = sample.formula,
+        .variables = sample.variables,
+        .aliases = sample.aliases,
+        .config = options.config,
+        .collapse_spaces = (seed % 2 == 0)
+    };
+}
+
+static differential_case_t make_fuzz_case(uint64_t seed) {
+    // Short formulas of tokens and symbols placed randomly,
+    // every third case with the custom tokens (and the default ones as plain symbols)
+    std::mt19937_64 generator(seed);
+    const char * const default_fragments[] = { "a", "b", "x", " ", "  ", "\t", "\n", "$", "[", "]", "##", "#", ":", ",", ".", "!", "$[", "_", "1", "é" };
+    const char * const custom_fragments[] = { "a", "b", "x", " ", "  ", "\t", "\n", "@", "{{", "}}", "{", "}", "||", "|", "~", "~~", "@{{", "$[", "#", "_", "1", "é" };
+
+    differential_case_t test_case;
+    const bool custom_tokens = (seed % 3 == 0);
+    if (custom_tokens) {
+        test_case.config = custom_config();
+    }
+
+    const char * const *fragments = (custom_tokens ? custom_fragments : default_fragments);
+    const size_t fragments_number = (custom_tokens ? std::size(custom_fragments) : std::size(default_fragments));
+
+    for (size_t index = 0, length = generator() % 24; index < length; index++) {
+        test_case.formula += fragments[generator() % fragments_number];
+    }
+
+    for (const char *name : { "a", "b", "x", "ab", "b1", "a_" }) {
+        if (generator() % 2) {
+            test_case.variables[name] = fragments[generator() % fragments_number];
+        }
+    }
+
+    for (const char *name : { "a", "b", "x", "" }) {
+        if (generator() % 2) {
+            test_case.aliases.insert(name);
+        }
+    }
+
+    test_case.collapse_spaces = (generator() % 2 == 0);
+    return test_case;
+}
+
+#pragma mark - Engines
+
+static std::string execute_reference(const differential_case_t &test_case) {
+    PureReferenceParser parser(test_case.config);
+    assign_bindings(parser, test_case);
+    return parser.execute(test_case.formula, test_case.collapse_spaces, true);
+}
+
+static std::string execute_textual(const differential_case_t &test_case) {
+    PureParser parser(test_case.config);
+    assign_bindings(parser, test_case);
+    return parser.execute(test_case.formula, test_case.collapse_spaces, true);
+}
+
+static std::string execute_compiled(const differential_case_t &test_case) {
+    PureParser parser(test_case.config);
+    assign_bindings(parser, test_case);
+    const PureFormula formula = parser.compile(test_case.formula);
+    return parser.execute(formula, test_case.collapse_spaces, true);
+}
+
+static std::string execute_chunked(const differential_case_t &test_case) {
+    PureParser parser(test_case.config);
+    assign_bindings(parser, test_case);
+    const PureFormula formula = parser.compile(test_case.formula);
+
+    std::string output;
+    parser.execute(formula, test_case.collapse_spaces, true, 16, [&](std::string_view chunk) { output.append(chunk); });
+    return output;
+}
+
+static std::string execute_vectored(const differential_case_t &test_case) {
+    PureParser parser(test_case.config);
+    assign_bindings(parser, test_case);
+    const PureFormula formula = parser.compile(test_case.formula);
+
+    std::vector<struct iovec> vectors;
+    parser.execute(formula, test_case.collapse_spaces, vectors);
+
+    std::string output;
+    for (const auto &vector : vectors) {
+        output.append(static_cast<const char *>(vector.iov_base), vector.iov_len);
+    }
+
+    return output;
+}
+
+static std::string execute_streamed(const differential_case_t &test_case) {
+    std::list<PureElement> elements;
+    PureStreamParser stream_parser([&](const PureElement &element) { elements.push_back(element); }, test_case.config);
+
+    const std::string_view formula_view = test_case.formula;
+    for (size_t offset = 0; offset < formula_view.size(); offset += 7) {
+        stream_parser.feed(formula_view.substr(offset, 7));
+    }
+    stream_parser.finish();
+
+    PureParser parser(test_case.config);
+    assign_bindings(parser, test_case);
+    const PureFormula formula(test_case.formula, PureElement(PureElementTypeFrame, stream_parser.alias(), elements));
+    return parser.execute(formula, test_case.collapse_spaces, true);
+}
+
+static std::string execute_buffer(const differential_case_t &test_case) {
+    // Start with a tiny buffer, so that the truncated attempts must keep the bindings
+    PureParser parser(test_case.config);
+    assign_bindings(parser, test_case);
+    const PureFormula formula = parser.compile(test_case.formula);
+
+    std::string output(4, '\0');
+    for (;;) {
+        const size_t output_len = parser.execute(formula, test_case.collapse_spaces, true, output.data(), output.size());
+        if (output_len <= output.size()) {
+            output.resize(output_len);
+            return output;
+        }
+
+        output.resize(output_len);
+    }
+}
+
+static std::string execute_scope(const differential_case_t &test_case) {
+    // Variables in the parent scope, and aliases in the child one
+    PureBindings parent_scope;
+    for (const auto &variable : test_case.variables) {
+        parent_scope.assignVariable(variable.first, variable.second);
+    }
+
+    PureBindings child_scope(&parent_scope);
+    for (const auto &alias : test_case.aliases) {
+        child_scope.enableAlias(alias);
+    }
+
+    const PureParser parser(test_case.config);
+    const PureFormula formula = parser.compile(test_case.formula);
+    return parser.execute(formula, child_scope, test_case.collapse_spaces);
+}
+
+static std::string execute_view(const differential_case_t &test_case) {
+    // The case outlives the parser, so the values may be kept as views
+    PureParser parser(test_case.config);
+    for (const auto &variable : test_case.variables) {
+        parser.assignVariableView(variable.first, variable.second);
+    }
+
+    for (const auto &alias : test_case.aliases) {
+        parser.enableAlias(alias);
+    }
+
+    const PureFormula formula = parser.compile(test_case.formula);
+    return parser.execute(formula, test_case.collapse_spaces, true);
+}
+
+static std::string execute_session(const differential_case_t &test_case) {
+    // Attach before assigning, so that the refreshing gets checked as well
+    PureSession session(test_case.config);
+    const size_t output_id = session.attach(test_case.formula, test_case.collapse_spaces);
+    assign_bindings(session, test_case);
+    session.refresh();
+    return session.output(output_id);
+}
+
+#pragma mark - Entry point
+
+int main(int argc, const char *argv[]) {
+    uint64_t seed = 1;
+    size_t samples_number = 10000;
+    double noise = 0.05;
+    size_t max_reported = 10;
+
+    for (int index = 1; index < argc; index++) {
+        const std::string argument = argv[index];
+        if (argument.find("--seed=") == 0) {
+            seed = strtoull(argument.c_str() + strlen("--seed="), nullptr, 10);
+        }
+        else if (argument.find("--samples=") == 0) {
+            samples_number = strtoull(argument.c_str() + strlen("--samples="), nullptr, 10);
+        }
+        else if (argument.find("--noise=") == 0) {
+            noise = atof(argument.c_str() + strlen("--noise="));
+        }
+        else if (argument.find("--report=") == 0) {
+            max_reported = strtoull(argument.c_str() + strlen("--report="), nullptr, 10);
+        }
+        else {
+            std::cerr << "Usage: " << argv[0] << " [--seed=N] [--samples=N] [--noise=probability] [--report=N]" << std::endl;
+            return 1;
+        }
+    }
+
+    #define declare_engine(caption, func) differential_engine_t{caption, func, 0, 0}
+    std::vector<differential_engine_t> engines {
+        declare_engine("textual", execute_textual),
+        declare_engine("compiled", execute_compiled),
+        declare_engine("chunked", execute_chunked),
+        declare_engine("vectored", execute_vectored),
+        declare_engine("streamed", execute_streamed),
+        declare_engine("buffer", execute_buffer),
+        declare_engine("scope", execute_scope),
+        declare_engine("view", execute_view),
+        declare_engine("session", execute_session)
+    };
+    #undef declare_engine
+
+    typedef std::chrono::steady_clock clock;
+    double reference_elapsed_ns = 0;
+    size_t reported = 0;
+
+    for (size_t sample_index = 0; sample_index < samples_number; sample_index++) {
+        // Half of cases are generated formulas, and another half are fuzzed ones
+        const uint64_t case_seed = seed + sample_index;
+        const differential_case_t test_case = (sample_index % 2 == 0) ? make_corpus_case(case_seed, noise) : make_fuzz_case(case_seed);
+
+        const auto reference_started_at = clock::now();
+        const std::string reference = execute_reference(test_case);
+        reference_elapsed_ns += std::chrono::duration<double, std::nano>(clock::now() - reference_started_at).count();
+
+        for (auto &engine : engines) {
+            const auto started_at = clock::now();
+            const std::string output = engine.executor(test_case);
+            engine.elapsed_ns += std::chrono::duration<double, std::nano>(clock::now() - started_at).count();
+
+            if (output == reference) {
+                continue;
+            }
+
+            engine.mismatches++;
+            if (reported++ >= max_reported) {
+                continue;
+            }
+
+            std::cout << "Mismatch in \"" << engine.caption << "\", seed " << case_seed << std::endl;
+            std::cout << "> Formula: \"" << test_case.formula << "\"" << std::endl;
+            for (const auto &variable : test_case.variables) {
+                std::cout << "> Assign variable \"" << variable.first << "\" = \"" << variable.second << "\"" << std::endl;
+            }
+
+            for (const auto &alias : test_case.aliases) {
+                std::cout << "> Enable alias \"" << alias << "\"" << std::endl;
+            }
+
+            std::cout << "> Collapse spaces: " << (test_case.collapse_spaces ? "yes" : "no") << std::endl;
+            std::cout << "> Reference: \"" << reference << "\"" << std::endl;
+            std::cout << "> Output: \"" << output << "\"" << std::endl;
+            std::cout << std::endl;
+        }
+    }
+
+    // Summary, with speed relative to the reference
+    bool passed = true;
+    std::cout << std::left << std::setw(12) << "engine" << std::right << std::setw(12) << "mismatches" << std::setw(12) << "speedup" << std::endl;
+    for (const auto &engine : engines) {
+        std::cout << std::left << std::setw(12) << engine.caption
+            << std::right << std::setw(12) << engine.mismatches
+            << std::setw(11) << std::fixed << std::setprecision(2) << (reference_elapsed_ns / engine.elapsed_ns) << "x" << std::endl;
+
+        passed = passed && (engine.mismatches == 0);
+    }
+
+    if (passed) {
+        std::cout << "== All " << samples_number << " samples matched the reference ==" << std::endl;
+        return 0;
+    }
+    else {
+        return 1;
+    }
+}
@@ -0,0 +1,116 @@
+//
+//  PurePerfCounters.cpp
+//  PureParser
+//
+//  Copyright © 2019 JivoSite Inc. All rights reserved.
+//  <For detailed info about how this parser works, please refer to README.md file>
+//
+
+#include "PurePerfCounters.hpp"
+
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <cstring>
+
+static int open_event(uint64_t config, int group_descriptor) {
+    struct perf_event_attr attributes;
+    memset(&attributes, 0, sizeof(attributes));
+    attributes.size = sizeof(attributes);
+    attributes.type = PERF_TYPE_HARDWARE;
+    attributes.config = config;
+    attributes.disabled = (group_descriptor < 0 ? 1 : 0);
+    attributes.exclude_kernel = 1;
+    attributes.exclude_hv = 1;
+    attributes.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+    return static_cast<int>(syscall(__NR_perf_event_open, &attributes, 0, -1, group_descriptor, 0));
+}
+
+PurePerfCounters::PurePerfCounters() {
+    const uint64_t configs[PurePerfEventsNumber] = {
+        PERF_COUNT_HW_CPU_CYCLES,
+        PERF_COUNT_HW_INSTRUCTIONS,
+        PERF_COUNT_HW_CACHE_MISSES,
+        PERF_COUNT_HW_BRANCH_MISSES
+    };
+
+    // The first event leads the group, so all of them are scheduled together
+    for (size_t event = 0; event < PurePerfEventsNumber; event++) {
+        _descriptors[event] = open_event(configs[event], event > 0 ? _descriptors[0] : -1);
+        if (_descriptors[event] < 0) {
+            for (size_t opened = 0; opened < event; opened++) {
+                close(_descriptors[opened]);
+                _descriptors[opened] = -1;
+            }
+
+            break;
+        }
+    }
+}
+
+PurePerfCounters::~PurePerfCounters() {
+    if (isAvailable()) {
+        for (int descriptor : _descriptors) {
+            close(descriptor);
+        }
+    }
+}
+
+bool PurePerfCounters::isAvailable() const {
+    return (_descriptors[0] >= 0);
+}
+
+void PurePerfCounters::start() {
+    if (isAvailable()) {
+        ioctl(_descriptors[0], PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+        ioctl(_descriptors[0], PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+    }
+}
+
+void PurePerfCounters::stop(PurePerfSample &sample) {
+    if (not isAvailable()) {
+        return;
+    }
+
+    ioctl(_descriptors[0], PERF_EVENT_IOC_DISABLE, PERF_IOC_FLAG_GROUP);
+
+    // Layout of PERF_FORMAT_GROUP: number, time enabled, time running, values
+    uint64_t buffer[3 + PurePerfEventsNumber] = {};
+    if (read(_descriptors[0], buffer, sizeof(buffer)) < static_cast<ssize_t>(sizeof(buffer))) {
+        return;
+    }
+
+    const uint64_t time_enabled = buffer[1];
+    const uint64_t time_running = buffer[2];
+    const double scale = (time_running > 0 ? double(time_enabled) / time_running : 0);
+
+    for (size_t event = 0; event < PurePerfEventsNumber; event++) {
+        sample.values[event] += static_cast<uint64_t>(buffer[3 + event] * scale);
+    }
+}
+
+#else
+
+PurePerfCounters::PurePerfCounters() {
+    for (int &descriptor : _descriptors) {
+        descriptor = -1;
+    }
+}
+
+PurePerfCounters::~PurePerfCounters() {
+}
+
+bool PurePerfCounters::isAvailable() const {
+    return false;
+}
+
+void PurePerfCounters::start() {
+}
+
+void PurePerfCounters::stop(PurePerfSample &) {
+}
+
+#endif
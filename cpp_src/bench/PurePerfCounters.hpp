@@ -0,0 +1,69 @@
+//
+//  PurePerfCounters.hpp
+//  PureParser
+//
+//  Copyright © 2019 JivoSite Inc. All rights reserved.
+//  <For detailed info about how this parser works, please refer to README.md file>
+//
+
+#ifndef PurePerfCounters_hpp
+#define PurePerfCounters_hpp
+
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * Hardware events being counted
+ */
+enum PurePerfEvent {
+    PurePerfCycles,
+    PurePerfInstructions,
+    PurePerfCacheMisses,
+    PurePerfBranchMisses,
+    PurePerfEventsNumber
+};
+
+/**
+ * The counted values, in total for the measured interval;
+ * the values are scaled if the kernel had to multiplex the counters
+ */
+struct PurePerfSample {
+    uint64_t values[PurePerfEventsNumber] = {};
+};
+
+/**
+ * The group of hardware counters of the current thread,
+ * based on `perf_event_open` and available on Linux only
+ */
+class PurePerfCounters {
+public:
+    /**
+     * Open the counters;
+     * if the system doesn't allow that, the counters stay unavailable
+     */
+    PurePerfCounters();
+    ~PurePerfCounters();
+
+    PurePerfCounters(const PurePerfCounters&) = delete;
+    PurePerfCounters &operator=(const PurePerfCounters&) = delete;
+
+    /**
+     * Whether the counters have been opened successfully
+     */
+    bool isAvailable() const;
+
+    /**
+     * Reset and start counting
+     */
+    void start();
+
+    /**
+     * Stop counting, and accumulate the counted values into the sample
+     */
+    void stop(PurePerfSample &sample);
+
+private:
+    int _descriptors[PurePerfEventsNumber];
+};
+
+#endif /* PurePerfCounters_hpp */
@@ -0,0 +1,408 @@
+//
+//  PureRender.cpp
+//  PureParser
+//
+//  Copyright © 2019 JivoSite Inc. All rights reserved.
+//  <For detailed info about how this parser works, please refer to README.md file>
+//
+
+#include "../PureParser.hpp"
+#include "../PureBindings.hpp"
+#include "../PureBundleManager.hpp"
+#include "../PureJson.hpp"
+#include "../PureSharedTable.hpp"
+#include "PureRenderJob.hpp"
+#include <condition_variable>
+#include <cstdio>
+#include <cstring>
+#include <deque>
+#include <iostream>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#pragma mark - Local Types
+
+/**
+ * The piece of input lines, rendered by any worker and written in order
+ */
+typedef struct {
+    /// The lines read from stdin; the mapped file is not copied
+    std::string storage;
+    std::string_view lines;
+
+    std::string output;
+    bool rendered;
+} render_batch_t;
+
+/**
+ * The batches being rendered, in the input order
+ */
+typedef struct {
+    std::mutex mutex;
+    std::condition_variable reader_condition;
+    std::condition_variable worker_condition;
+    std::condition_variable writer_condition;
+
+    std::deque<std::unique_ptr<render_batch_t>> pending_batches;
+    std::deque<render_batch_t *> unrendered_batches;
+    size_t max_pending;
+    bool input_finished;
+} render_queue_t;
+
+/**
+ * The textual formulas compiled by a worker, the most recently used first;
+ * the index keys point into the list items, which never move
+ */
+typedef struct {
+    std::list<std::pair<std::string, PureFormula>> recent_formulas;
+    std::unordered_map<std::string_view, std::list<std::pair<std::string, PureFormula>>::iterator> index;
+} render_formulas_t;
+
+/**
+ * What is shared between workers, and never changed while rendering
+ */
+typedef struct {
+    const PureParser *parser;
+    const PureBundleManager *bundles;
+    const PureSharedTable *shared_table;
+} render_context_t;
+
+static const size_t kRenderBatchSize = 64 * 1024;
+static const size_t kRenderFormulasCacheCapacity = 4096;
+static const char *kRenderBundleName = "bundle";
+
+#pragma mark - Local Helpers
+
+static void enqueue_batch(render_queue_t &queue, std::unique_ptr<render_batch_t> batch) {
+    std::unique_lock<std::mutex> lock(queue.mutex);
+    queue.reader_condition.wait(lock, [&] { return queue.pending_batches.size() < queue.max_pending; });
+
+    queue.unrendered_batches.push_back(batch.get());
+    queue.pending_batches.push_back(std::move(batch));
+    lock.unlock();
+
+    queue.worker_condition.notify_one();
+}
+
+static void finish_input(render_queue_t &queue) {
+    std::unique_lock<std::mutex> lock(queue.mutex);
+    queue.input_finished = true;
+    lock.unlock();
+
+    queue.worker_condition.notify_all();
+    queue.writer_condition.notify_all();
+}
+
+static void read_mapped(render_queue_t &queue, std::string_view contents) {
+    // Split at line ends, so that every batch has whole lines
+    for (size_t offset = 0; offset < contents.size();) {
+        const size_t line_end = contents.find('\n', std::min(offset + kRenderBatchSize, contents.size()) - 1);
+        const size_t batch_end = (line_end == std::string_view::npos ? contents.size() : line_end + 1);
+
+        auto batch = std::make_unique<render_batch_t>();
+        batch->lines = contents.substr(offset, batch_end - offset);
+        batch->rendered = false;
+        enqueue_batch(queue, std::move(batch));
+
+        offset = batch_end;
+    }
+}
+
+static void read_stream(render_queue_t &queue, FILE *stream) {
+    std::string carried;
+    std::vector<char> buffer(kRenderBatchSize);
+
+    for (;;) {
+        const size_t read_len = fread(buffer.data(), 1, buffer.size(), stream);
+        carried.append(buffer.data(), read_len);
+
+        // Keep the incomplete last line for the next batch
+        const size_t last_line_end = carried.rfind('\n');
+        const bool stream_finished = (read_len < buffer.size());
+        const size_t batch_len = (stream_finished ? carried.size() : (last_line_end == std::string::npos ? 0 : last_line_end + 1));
+
+        if (batch_len > 0) {
+            auto batch = std::make_unique<render_batch_t>();
+            batch->storage = carried.substr(0, batch_len);
+            batch->lines = batch->storage;
+            batch->rendered = false;
+            carried.erase(0, batch_len);
+            enqueue_batch(queue, std::move(batch));
+        }
+
+        if (stream_finished) {
+            break;
+        }
+    }
+}
+
+static const PureFormula &obtain_formula(render_formulas_t &formulas, const PureParser &parser, const std::string &source) {
+    const auto index_iter = formulas.index.find(source);
+    if (index_iter != formulas.index.end()) {
+        formulas.recent_formulas.splice(formulas.recent_formulas.begin(), formulas.recent_formulas, index_iter->second);
+        return index_iter->second->second;
+    }
+
+    // Evict the least recently used formula only
+    if (formulas.recent_formulas.size() >= kRenderFormulasCacheCapacity) {
+        formulas.index.erase(formulas.recent_formulas.back().first);
+        formulas.recent_formulas.pop_back();
+    }
+
+    formulas.recent_formulas.emplace_front(source, parser.compile(source));
+    formulas.index.emplace(formulas.recent_formulas.front().first, formulas.recent_formulas.begin());
+    return formulas.recent_formulas.front().second;
+}
+
+static void render_line(std::string_view line, const render_context_t &context, PureBindings &bindings, render_formulas_t &formulas, std::string &output, std::string &target) {
+    PureRenderJob job;
+    if (not readRenderJob(line, job)) {
+        writeRenderError(std::string_view(), "invalid job", target);
+        return;
+    }
+
+    // The bundle may get reloaded meanwhile, so the one found is kept until rendered
+    const PureBundleManager::Reader bundles_reader = context.bundles->read();
+
+    // Compile the textual formulas once per worker
+    const PureFormula *formula = nullptr;
+    if (job.key.has_value()) {
+        formula = bundles_reader.findFormula(kRenderBundleName, *job.key);
+        if (formula == nullptr) {
+            writeRenderError(job.id, "unknown key", target);
+            return;
+        }
+    }
+    else if (job.formula.has_value()) {
+        formula = &obtain_formula(formulas, *context.parser, *job.formula);
+    }
+    else {
+        writeRenderError(job.id, "no formula", target);
+        return;
+    }
+
+    // Variables are read right from the line, and aliases are the array of names
+    bindings.reset();
+    if (not job.variables.empty() && not bindings.assignJsonView(job.variables)) {
+        writeRenderError(job.id, "invalid variables", target);
+        return;
+    }
+
+    PureJsonReader aliases_reader(job.aliases);
+    PureJsonField alias;
+    while (not job.aliases.empty() && aliases_reader.next(alias)) {
+        if (alias.type != PureJsonTypeString) {
+            writeRenderError(job.id, "invalid aliases", target);
+            return;
+        }
+
+        bindings.enableAlias(alias.value);
+    }
+
+    if (aliases_reader.failed()) {
+        writeRenderError(job.id, "invalid aliases", target);
+        return;
+    }
+
+    if (context.shared_table == nullptr) {
+        context.parser->execute(*formula, bindings, job.collapse_spaces, output);
+        writeRenderResult(job.id, output, target);
+        return;
+    }
+
+    // The shared variables lie beneath the job ones, and get rendered again if republished meanwhile
+    for (;;) {
+        const PureSharedTable::Reader shared_reader = context.shared_table->read();
+        bindings.setParent(&shared_reader);
+        context.parser->execute(*formula, bindings, job.collapse_spaces, output);
+        bindings.setParent(nullptr);
+
+        if (shared_reader.isConsistent()) {
+            break;
+        }
+    }
+
+    writeRenderResult(job.id, output, target);
+}
+
+static void render_worker(render_queue_t &queue, const render_context_t &context) {
+    PureBindings bindings;
+    render_formulas_t formulas;
+    std::string output;
+
+    for (;;) {
+        std::unique_lock<std::mutex> lock(queue.mutex);
+        queue.worker_condition.wait(lock, [&] { return not queue.unrendered_batches.empty() || queue.input_finished; });
+        if (queue.unrendered_batches.empty()) {
+            return;
+        }
+
+        render_batch_t *batch = queue.unrendered_batches.front();
+        queue.unrendered_batches.pop_front();
+        lock.unlock();
+
+        // Blank lines are skipped
+        for (size_t offset = 0; offset < batch->lines.size();) {
+            const size_t line_end = std::min(batch->lines.find('\n', offset), batch->lines.size());
+            const std::string_view line = batch->lines.substr(offset, line_end - offset);
+            if (line.find_first_not_of(" \t\r") != std::string_view::npos) {
+                render_line(line, context, bindings, formulas, output, batch->output);
+            }
+
+            offset = line_end + 1;
+        }
+
+        lock.lock();
+        batch->rendered = true;
+        lock.unlock();
+        queue.writer_condition.notify_all();
+    }
+}
+
+static void write_batches(render_queue_t &queue, FILE *stream) {
+    for (;;) {
+        std::unique_lock<std::mutex> lock(queue.mutex);
+        queue.writer_condition.wait(lock, [&] {
+            return queue.pending_batches.empty() ? queue.input_finished : queue.pending_batches.front()->rendered;
+        });
+
+        if (queue.pending_batches.empty()) {
+            return;
+        }
+
+        std::unique_ptr<render_batch_t> batch = std::move(queue.pending_batches.front());
+        queue.pending_batches.pop_front();
+        lock.unlock();
+
+        queue.reader_condition.notify_one();
+        fwrite(batch->output.data(), 1, batch->output.size(), stream);
+    }
+}
+
+#pragma mark - Entry point
+
+int main(int argc, const char *argv[]) {
+    std::optional<std::string> input_path;
+    std::optional<std::string> bundle_path;
+    std::optional<std::string> shared_path;
+    bool watching = false;
+    size_t threads_number = std::max(1u, std::thread::hardware_concurrency());
+
+    for (int index = 1; index < argc; index++) {
+        const std::string argument = argv[index];
+        if (argument.find("--input=") == 0) {
+            input_path = argument.substr(strlen("--input="));
+        }
+        else if (argument.find("--bundle=") == 0) {
+            bundle_path = argument.substr(strlen("--bundle="));
+        }
+        else if (argument == "--watch") {
+            watching = true;
+        }
+        else if (argument.find("--shared=") == 0) {
+            shared_path = argument.substr(strlen("--shared="));
+        }
+        else if (argument.find("--threads=") == 0) {
+            threads_number = std::max(1ull, strtoull(argument.c_str() + strlen("--threads="), nullptr, 10));
+        }
+        else {
+            std::cerr << "Usage: " << argv[0] << " [--input=jobs.ndjson] [--bundle=formulas.strings [--watch]] [--shared=table] [--threads=N]" << std::endl;
+            return 1;
+        }
+    }
+
+    const PureParser parser;
+    PureBundleManager bundles(parser);
+    if (bundle_path.has_value()) {
+        if (not bundles.add(kRenderBundleName, *bundle_path)) {
+            std::cerr << "Cannot read the bundle \"" << *bundle_path << "\"" << std::endl;
+            return 1;
+        }
+
+        if (watching && not bundles.startWatching()) {
+            std::cerr << "Cannot watch the bundle \"" << *bundle_path << "\"" << std::endl;
+            return 1;
+        }
+    }
+
+    std::optional<PureSharedTable> shared_table;
+    if (shared_path.has_value()) {
+        shared_table = PureSharedTable::open(*shared_path);
+        if (not shared_table.has_value()) {
+            std::cerr << "Cannot open the shared table \"" << *shared_path << "\"" << std::endl;
+            return 1;
+        }
+    }
+
+    // Map the input file instead of reading it
+    std::string_view mapped_input;
+    if (input_path.has_value()) {
+        const int input_fd = open(input_path->c_str(), O_RDONLY);
+        struct stat input_stat;
+        if (input_fd < 0 || fstat(input_fd, &input_stat) != 0) {
+            std::cerr << "Cannot read the input \"" << *input_path << "\"" << std::endl;
+            return 1;
+        }
+
+        if (input_stat.st_size > 0) {
+            void *mapping = mmap(nullptr, input_stat.st_size, PROT_READ, MAP_PRIVATE, input_fd, 0);
+            if (mapping == MAP_FAILED) {
+                std::cerr << "Cannot map the input \"" << *input_path << "\"" << std::endl;
+                return 1;
+            }
+
+            mapped_input = std::string_view(static_cast<const char *>(mapping), input_stat.st_size);
+        }
+
+        close(input_fd);
+    }
+
+    render_queue_t queue;
+    queue.max_pending = threads_number * 4;
+    queue.input_finished = false;
+
+    const render_context_t context {
+        .parser = &parser,
+        .bundles = &bundles,
+        .shared_table = (shared_table.has_value() ? &*shared_table : nullptr)
+    };
+
+    std::vector<std::thread> workers;
+    for (size_t index = 0; index < threads_number; index++) {
+        workers.emplace_back(render_worker, std::ref(queue), std::cref(context));
+    }
+
+    std::thread reader([&] {
+        if (input_path.has_value()) {
+            read_mapped(queue, mapped_input);
+        }
+        else {
+            read_stream(queue, stdin);
+        }
+
+        finish_input(queue);
+    });
+
+    write_batches(queue, stdout);
+
+    reader.join();
+    for (auto &worker : workers) {
+        worker.join();
+    }
+
+    if (not mapped_input.empty()) {
+        munmap(const_cast<char *>(mapped_input.data()), mapped_input.size());
+    }
+
+    fflush(stdout);
+    return 0;
+}
@@ -0,0 +1,114 @@
+//
+//  PureRenderJob.cpp
+//  PureParser
+//
+//  Copyright © 2019 JivoSite Inc. All rights reserved.
+//  <For detailed info about how this parser works, please refer to README.md file>
+//
+
+#include "PureRenderJob.hpp"
+#include "../PureJson.hpp"
+
+static void write_escaped(std::string_view value, std::string &target);
+static void write_result_head(std::string_view id, std::string &target);
+
+#pragma mark - Public
+
+bool readRenderJob(std::string_view line, PureRenderJob &job) {
+    PureJsonReader reader(line);
+    PureJsonField field;
+    job = PureRenderJob();
+
+    while (reader.next(field)) {
+        if (field.name == "id") {
+            // Strings are decoded by the reader, so write them back as JSON
+            if (field.type == PureJsonTypeString) {
+                job.id.push_back('"');
+                write_escaped(field.value, job.id);
+                job.id.push_back('"');
+            }
+            else {
+                job.id.assign(field.value);
+            }
+        }
+        else if (field.name == "formula" || field.name == "key") {
+            if (field.type != PureJsonTypeString) {
+                return false;
+            }
+
+            (field.name == "formula" ? job.formula : job.key) = std::string(field.value);
+        }
+        else if (field.name == "variables") {
+            if (field.type != PureJsonTypeObject) {
+                return false;
+            }
+
+            job.variables = field.value;
+        }
+        else if (field.name == "aliases") {
+            if (field.type != PureJsonTypeArray) {
+                return false;
+            }
+
+            job.aliases = field.value;
+        }
+        else if (field.name == "collapse") {
+            if (field.type != PureJsonTypeTrue && field.type != PureJsonTypeFalse) {
+                return false;
+            }
+
+            job.collapse_spaces = (field.type == PureJsonTypeTrue);
+        }
+    }
+
+    return not reader.failed();
+}
+
+void writeRenderResult(std::string_view id, std::string_view output, std::string &target) {
+    write_result_head(id, target);
+    target.append("\"output\":\"");
+    write_escaped(output, target);
+    target.append("\"}\n");
+}
+
+void writeRenderError(std::string_view id, std::string_view message, std::string &target) {
+    write_result_head(id, target);
+    target.append("\"error\":\"");
+    write_escaped(message, target);
+    target.append("\"}\n");
+}
+
+#pragma mark - Local Helpers
+
+static void write_escaped(std::string_view value, std::string &target) {
+    static const char hex_digits[] = "0123456789abcdef";
+
+    for (const char symbol : value) {
+        switch (symbol) {
+            case '"': target.append("\\\""); break;
+            case '\\': target.append("\\\\"); break;
+            case '\n': target.append("\\n"); break;
+            case '\r': target.append("\\r"); break;
+            case '\t': target.append("\\t"); break;
+            default:
+                if (static_cast<unsigned char>(symbol) < 0x20) {
+                    target.append("\\u00");
+                    target.push_back(hex_digits[symbol >> 4]);
+                    target.push_back(hex_digits[symbol & 0x0F]);
+                }
+                else {
+                    target.push_back(symbol);
+                }
+                break;
+        }
+    }
+}
+
+static void write_result_head(std::string_view id, std::string &target) {
+    target.push_back('{');
+    if (not id.empty()) {
+        target.append("\"id\":");
+        target.append(id);
+        target.push_back(',');
+    }
+}
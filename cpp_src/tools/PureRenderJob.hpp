@@ -0,0 +1,47 @@
+//
+//  PureRenderJob.hpp
+//  PureParser
+//
+//  Copyright © 2019 JivoSite Inc. All rights reserved.
+//  <For detailed info about how this parser works, please refer to README.md file>
+//
+
+#ifndef PureRenderJob_hpp
+#define PureRenderJob_hpp
+
+#include <string>
+#include <string_view>
+#include <optional>
+
+/**
+ * The single job of the render tool, being read from the line like
+ * `{"id": 1, "key": "coupons", "variables": {"number": "7"}, "aliases": ["target"], "collapse": true}`;
+ * either `formula` or bundle `key` is expected
+ */
+struct PureRenderJob {
+    /// The `id` value as JSON, to be copied into the result
+    std::string id;
+
+    std::optional<std::string> formula;
+    std::optional<std::string> key;
+
+    /// The flat JSON object and the JSON array of strings, pointing right into the line
+    std::string_view variables;
+    std::string_view aliases;
+
+    bool collapse_spaces = true;
+};
+
+/**
+ * Read the job from the JSON line;
+ * @return `false` if the line is not the valid job object
+ */
+bool readRenderJob(std::string_view line, PureRenderJob &job);
+
+/**
+ * Append the result line, with the rendered output or the error message
+ */
+void writeRenderResult(std::string_view id, std::string_view output, std::string &target);
+void writeRenderError(std::string_view id, std::string_view message, std::string &target);
+
+#endif /* PureRenderJob_hpp */
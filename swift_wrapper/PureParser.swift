@@ -21,6 +21,7 @@ public protocol IPureParser: class {
 @objc(PureParser) public final class PureParser: NSObject, IPureParser {
     private var config = pure_config_t()
     private var parser = pure_parser_t()
+    private var buffer = [Int8](repeating: 0, count: 256)
     
     public override init() {
         super.init()
@@ -51,15 +52,80 @@ public protocol IPureParser: class {
     }
     
     @objc(execute:collapseSpaces:resetOnFinish:) public func execute(_ formula: String, collapseSpaces: Bool, resetOnFinish: Bool) -> String {
-        var result: UnsafeMutablePointer<Int8>?
-        var result_len = UInt(0)
-        pure_parser_execute(&parser, formula, collapseSpaces, resetOnFinish, &result, &result_len)
+        // Perform into the buffer being reused between executions,
+        // and grow it if the output does not fit
+        var result_len = Int(pure_parser_perform(&parser, formula, collapseSpaces, resetOnFinish, &buffer, UInt(buffer.count)))
+        if result_len >= buffer.count {
+            buffer = [Int8](repeating: 0, count: result_len + 1)
+            result_len = Int(pure_parser_perform(&parser, formula, collapseSpaces, resetOnFinish, &buffer, UInt(buffer.count)))
+        }
         
-        if let result = result, result_len > 0 {
-            return String(bytesNoCopy: result, length: Int(result_len), encoding: .utf8, freeWhenDone: true) ?? String()
+        return buffer.withUnsafeBytes { bytes in
+            String(decoding: bytes.prefix(result_len), as: UTF8.self)
+        }
+    }
+}
+
+@objc(PureBindings) public final class PureBindings: NSObject {
+    fileprivate var bindings = pure_bindings_t()
+    
+    public override init() {
+        super.init()
+        pure_bindings_init(&bindings)
+    }
+    
+    deinit {
+        pure_bindings_destroy(&bindings)
+    }
+    
+    @objc(assignVariable:value:) public func assign(variable name: String, value: String?) {
+        if let value = value {
+            pure_bindings_assign_var(&bindings, name, value)
         }
         else {
-            return String()
+            pure_bindings_discard_var(&bindings, name)
+        }
+    }
+    
+    @objc(activateAlias:rule:) public func activate(alias: String, _ rule: Bool) {
+        if rule {
+            pure_bindings_enable_alias(&bindings, alias)
+        }
+        else {
+            pure_bindings_discard_alias(&bindings, alias)
+        }
+    }
+    
+    @objc(reset) public func reset() {
+        pure_bindings_reset(&bindings)
+    }
+}
+
+@objc(PureCompiledFormula) public final class PureCompiledFormula: NSObject {
+    private var config = pure_config_t()
+    private var formula = pure_formula_t()
+    
+    @objc(initWithSource:) public init(_ source: String) {
+        super.init()
+        pure_config_set_default(&config)
+        pure_formula_init(&formula, &config, source)
+    }
+    
+    deinit {
+        pure_formula_destroy(&formula)
+    }
+    
+    @objc(executeWithBindings:collapseSpaces:) public func execute(bindings: PureBindings, collapseSpaces: Bool) -> String {
+        // Nothing is shared between executions, so the formula can be executed from any thread
+        var buffer = [Int8](repeating: 0, count: 256)
+        var result_len = Int(pure_formula_perform(&formula, &bindings.bindings, collapseSpaces, &buffer, UInt(buffer.count)))
+        if result_len >= buffer.count {
+            buffer = [Int8](repeating: 0, count: result_len + 1)
+            result_len = Int(pure_formula_perform(&formula, &bindings.bindings, collapseSpaces, &buffer, UInt(buffer.count)))
+        }
+        
+        return buffer.withUnsafeBytes { bytes in
+            String(decoding: bytes.prefix(result_len), as: UTF8.self)
         }
     }
 }